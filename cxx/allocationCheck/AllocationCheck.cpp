@@ -0,0 +1,168 @@
+/**
+ * @file AllocationCheck.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Check that the submit -> execute -> notify path does not allocate memory in a steady state (with
+ * logging disabled). The global operator new is replaced by one which counts the allocations. Each
+ * configuration of the engine is warmed up (so that its queues reach their final capacity) and then
+ * the allocations made while processing the operations are counted. The program fails if any
+ * configuration allocates.
+ * Usage: AllocationCheck [ROUNDS]
+ *   (default: 1000 rounds of 64 operations, after 100 rounds of warm-up)
+ * @see initiatorCompletion/InitiatorCompletion
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../check/CompletionCounter.hpp"
+#include "../check/TestOperation.hpp"
+#include "../executor/SharedExecutor.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../logger/Logger.hpp"
+#include "../policy/Policies.hpp"
+
+using namespace proactor;
+
+/**
+ * Indicates whether the allocations are counted
+ */
+static std::atomic<bool> counting(false);
+/**
+ * Allocations made while counting
+ */
+static std::atomic<unsigned long> allocations(0);
+
+void* operator new(std::size_t size) {
+	if (counting.load(std::memory_order_relaxed))
+		allocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = std::malloc(size ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+// The deallocation functions are not inlined: otherwise, the compiler would see a free of the memory
+// returned by operator new and warn about a mismatch
+__attribute__((noinline)) void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete[](void* memory) noexcept {
+	std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete[](void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+/**
+ * Operations processed per round
+ */
+const size_t ROUND_SIZE = 64;
+/**
+ * Rounds of warm-up
+ */
+const size_t WARM_UP_ROUNDS = 100;
+
+/**
+ * Process rounds of operations, waiting for the completions of each round before the next one (so
+ * that the depth of the queues is bounded, and reached during the warm-up). Half of the rounds submit
+ * the operations one by one and the other half as a batch
+ * @param[in] initiator		Engine
+ * @param[in] counter		Handler of the engine
+ * @param[in] operations	Operations of a round (reused in each round)
+ * @param[in] rounds		Number of rounds
+ */
+template <typename Initiator>
+void process(Initiator& initiator, check::CompletionCounter& counter,
+			 std::vector<asyncOperation::AsynchronousOperation<long>*>& operations, const size_t rounds) {
+	for (size_t round = 0; round < rounds; ++round) {
+		const size_t target = counter.completed.load() + operations.size();
+		if (round % 2 == 0) {
+			for (asyncOperation::AsynchronousOperation<long>* operation : operations)
+				initiator.processOperation(operation);
+		} else {
+			initiator.processOperations(operations.begin(), operations.end());
+		}
+		while (counter.completed.load() < target)
+			std::this_thread::yield();
+	}
+}
+
+/**
+ * Count the allocations of an engine in a steady state
+ * @param[in] name			Name of the configuration
+ * @param[in] initiator		Engine
+ * @param[in] counter		Handler of the engine
+ * @param[in] rounds		Number of measured rounds
+ * @return					True if no allocation has been made
+ */
+template <typename Initiator>
+bool checkAllocations(const std::string& name, Initiator& initiator, check::CompletionCounter& counter, const size_t rounds) {
+	std::vector<check::TestOperation> storage(ROUND_SIZE);
+	std::vector<asyncOperation::AsynchronousOperation<long>*> operations;
+	for (check::TestOperation& operation : storage)
+		operations.push_back(&operation);
+
+	// A round with a slow handler lets the completions pile up, so that the completion event queue
+	// reaches its maximum depth (a whole round) during the warm-up
+	counter.setHandlingTime(std::chrono::microseconds(200));
+	process(initiator, counter, operations, 1);
+	counter.setHandlingTime(std::chrono::nanoseconds::zero());
+	process(initiator, counter, operations, WARM_UP_ROUNDS);
+	allocations.store(0);
+	counting.store(true);
+	process(initiator, counter, operations, rounds);
+	counting.store(false);
+
+	const unsigned long counted = allocations.load();
+	std::cout << name << ": " << counted << " allocations in " << rounds * ROUND_SIZE << " operations" << std::endl;
+	return counted == 0;
+}
+
+int main(int argc, char *argv[]) {
+	const size_t rounds = (argc > 1) ? std::stoul(argv[1]) : 1000;
+	logger::Logger::setEnabled(false);
+	bool passed = true;
+	{
+		check::CompletionCounter counter;
+		initiatorCompletion::InitiatorCompletion<long> initiator(&counter, asyncOperation::CompletionMode::SERIALIZED, 4);
+		passed &= checkAllocations("serialized completions  ", initiator, counter, rounds);
+	}
+	{
+		check::CompletionCounter counter;
+		initiatorCompletion::InitiatorCompletion<long> initiator(&counter, asyncOperation::CompletionMode::INLINE, 4);
+		passed &= checkAllocations("inline completions      ", initiator, counter, rounds);
+	}
+	{
+		std::shared_ptr<executor::SharedExecutor> executor = std::make_shared<executor::SharedExecutor>(2);
+		check::CompletionCounter counter;
+		initiatorCompletion::InitiatorCompletion<long> initiator(&counter, asyncOperation::CompletionMode::SERIALIZED, 4,
+				nullptr, nullptr, executor);
+		passed &= checkAllocations("shared executor         ", initiator, counter, rounds);
+	}
+	{
+		check::CompletionCounter counter;
+		initiatorCompletion::InitiatorCompletion<long, policy::MinimalPolicies> initiator(&counter);
+		passed &= checkAllocations("caller thread (minimal) ", initiator, counter, rounds);
+	}
+	std::cout << (passed ? "PASSED" : "FAILED: the steady state allocates memory") << std::endl;
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
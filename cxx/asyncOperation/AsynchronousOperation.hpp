@@ -13,18 +13,43 @@
 
 #include "AsynchronousOperation.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
 #include "../observer/Observer.hpp"
 #include "../logger/Logger.hpp"
+#include "../policy/LoggingPolicy.hpp"
+#include "../trace/TraceRecorder.hpp"
 #include "../utils/Utils.hpp"
 
 namespace proactor {
 namespace asyncOperation {
 
+/**
+ * Defines in which thread the completion handler of an operation is invoked
+ */
+enum class CompletionMode : uint8_t {
+	/**
+	 * Use the completion mode configured in the engine (InitiatorCompletion)
+	 */
+	ENGINE_DEFAULT,
+	/**
+	 * Invoke the completion handler directly in the worker thread which has executed the
+	 * operation. The handler may therefore be called concurrently from different threads
+	 */
+	INLINE,
+	/**
+	 * Put the completion event in the completion event queue, so that the proactor thread
+	 * invokes the handlers one after another
+	 */
+	SERIALIZED
+};
+
 /**
  * This class represents a generic asynchronous operation.
  * The fact of using a template class is because the output might be of a generic type.
@@ -33,14 +58,19 @@ template<typename T>
 class AsynchronousOperation {
 private:
 	/**
-	 * Operation identifier for all operations. It is incremented after each operation.
+	 * Operation identifier for all operations. It is incremented after each operation (operations
+	 * may be created in several threads, e.g. by the journal replay or the shared memory server).
 	 */
-	static unsigned long long operationId;
+	static std::atomic<unsigned long long> operationId;
 protected:
 	/**
 	 * Operation identifier
 	 */
 	const unsigned long long opId;
+	/**
+	 * Time when the operation was submitted to the processor
+	 */
+	std::chrono::system_clock::time_point submitTime;
 	/**
 	 * Start time
 	 */
@@ -49,15 +79,24 @@ protected:
 	 * End time
 	 */
 	std::chrono::system_clock::time_point endTime;
-	/**
-	 * Indicates whether the operation has being executed or not
-	 */
-	bool executed;
 	/**
 	 * Observer of this class. In this case, we implement the observer design pattern
 	 * in order to notify that the given operation has finished its execution
 	 */
 	observer::Observer<AsynchronousOperation<T> >* observer;
+	/**
+	 * Slot of the operation in the table of the processor while it is not completed. It is only
+	 * valid while the operation is in flight: the slot is reused once the operation is completed
+	 */
+	uint32_t slot;
+	/**
+	 * Thread in which the completion handler must be invoked
+	 */
+	CompletionMode completionMode;
+	/**
+	 * Indicates whether the operation has being executed or not
+	 */
+	bool executed;
 	/**
 	 * Result of the operation.
 	 */
@@ -66,7 +105,8 @@ protected:
 	/**
 	 * Class constructor.
 	 */
-	AsynchronousOperation()  : opId(++operationId), startTime(), endTime(), executed(false), observer(NULL), result() {
+	AsynchronousOperation()  : opId(operationId.fetch_add(1, std::memory_order_relaxed) + 1), submitTime(), startTime(), endTime(),
+			observer(NULL), slot(0), completionMode(CompletionMode::ENGINE_DEFAULT), executed(false), result() {
 	};
 
 	/**
@@ -84,21 +124,47 @@ public:
 		this->observer = observer;
 	};
 
+	/**
+	 * Set the thread in which the completion handler of this operation is invoked. Cheap handlers
+	 * which do not require serialization can be invoked inline in the worker thread, avoiding the
+	 * completion event queue.
+	 * @param[in] completionMode	Completion mode of the operation
+	 * @see CompletionMode
+	 */
+	void setCompletionMode(const CompletionMode completionMode) {
+		this->completionMode = completionMode;
+	};
+
+	/**
+	 * Obtain the completion mode of the operation
+	 */
+	CompletionMode getCompletionMode() const {
+		return completionMode;
+	};
+
 	/**
 	 * This method implements the template pattern. It gets the start and end time of the operation execution
 	 * and invokes the derived "executeOperation" method from the derived class.
+	 * @tparam Logging	Logging policy of the engine which executes the operation (see policy::LoggingPolicy).
+	 * 					With NoLogging, the messages are not even built
 	 */
+	template <typename Logging = policy::SyncLogging>
 	void execute() {
 		// Set the start time
 		startTime = std::chrono::system_clock::now();
-		proactor::logger::Logger::log("\tStarting operation ", opId, std::this_thread::get_id(), startTime);
+		proactor::trace::traceEvent(proactor::trace::TraceEvent::START, opId);
+		// The check avoids building the message when logging is disabled
+		if (Logging::isEnabled())
+			Logging::log(proactor::logger::Logger::format("\tStarting operation ", opId, std::this_thread::get_id(), startTime));
 
 		// Use the template pattern
 		executeOperation();
 
 		// Set the finish time
 		endTime = std::chrono::system_clock::now();
-		proactor::logger::Logger::log("\tFinished operation ", opId, std::this_thread::get_id(), startTime, endTime);
+		proactor::trace::traceEvent(proactor::trace::TraceEvent::END, opId);
+		if (Logging::isEnabled())
+			Logging::log(proactor::logger::Logger::format("\tFinished operation ", opId, std::this_thread::get_id(), startTime, endTime));
 		// Notify the observer, if defined
 		if (observer != NULL)
 			observer->notify(this);
@@ -107,10 +173,107 @@ public:
 	/**
 	 * Obtain the operation identifier
 	 */
-	const unsigned int getId() const {
+	unsigned long long getId() const {
 		return opId;
 	};
 
+	/**
+	 * Set the slot of the operation in the table of the processor
+	 * @param[in] slot	Slot
+	 * @see operationTable::OperationTable
+	 */
+	void setSlot(const uint32_t slot) {
+		this->slot = slot;
+	};
+
+	/**
+	 * Obtain the slot of the operation in the table of the processor
+	 */
+	uint32_t getSlot() const {
+		return slot;
+	};
+
+	/**
+	 * Set the time when the operation was submitted to the processor
+	 * @param[in] submitTime	Submission time
+	 */
+	void setSubmitTime(const std::chrono::system_clock::time_point& submitTime) {
+		this->submitTime = submitTime;
+	};
+
+	/**
+	 * Obtain the time when the operation was submitted to the processor
+	 */
+	const std::chrono::system_clock::time_point& getSubmitTime() const {
+		return submitTime;
+	};
+
+	/**
+	 * Obtain the time when the execution of the operation started
+	 */
+	const std::chrono::system_clock::time_point& getStartTime() const {
+		return startTime;
+	};
+
+	/**
+	 * Obtain the time when the execution of the operation finished
+	 */
+	const std::chrono::system_clock::time_point& getEndTime() const {
+		return endTime;
+	};
+
+	/**
+	 * Obtain the name under which the type of the operation is registered, so that it can be
+	 * re-created from its arguments (e.g. to replay it from a journal).
+	 * @return	Name of the type, or an empty string if the operation cannot be serialized
+	 * @see registry::OperationRegistry
+	 */
+	virtual std::string getTypeName() const {
+		return std::string();
+	};
+
+	/**
+	 * Serialize the arguments of the operation (i.e. what is needed to re-create it, not its result)
+	 * @return	Serialized arguments
+	 */
+	virtual std::string serializeArguments() const {
+		return std::string();
+	};
+
+	/**
+	 * Obtain the content key of the operation: two operations with the same key must produce the
+	 * same result, so that one of them can be completed with the result of the other (see completeWith)
+	 * instead of being executed. Only pure operations can define it.
+	 * @return	Content key, or an empty string if the operation cannot be deduplicated
+	 * @see asyncOperationProcessor::AsynchronousOperationProcessor::setDeduplication
+	 */
+	virtual std::string getContentKey() const {
+		return std::string();
+	};
+
+	/**
+	 * Complete the operation with the result of an equivalent one (same content key), without
+	 * executing it. The observer is not notified.
+	 * @param[in] result	Result of the equivalent operation
+	 */
+	void completeWith(const T& result) {
+		startTime = endTime = std::chrono::system_clock::now();
+		this->result = result;
+		executed = true;
+	};
+
+	/**
+	 * Obtain the operation whose completion has to be dispatched once this one has been executed. It is
+	 * the operation itself, except for the parts of a composite operation: they return the composite
+	 * operation once all the parts have been executed, and NULL before (nothing is dispatched).
+	 * It is called once per execution, by the observer, when it does not use this operation anymore:
+	 * once the last part has been counted, the composite operation and all its parts may be released.
+	 * @return	Completed operation, or NULL if there is nothing to dispatch
+	 */
+	virtual AsynchronousOperation<T>* getCompletedOperation() {
+		return this;
+	};
+
 	/**
 	 * Retrieve the operation result (if exists)
 	 */
@@ -123,7 +286,7 @@ public:
 };
 
 template<typename T>
-unsigned long long AsynchronousOperation<T>::operationId = 0;
+std::atomic<unsigned long long> AsynchronousOperation<T>::operationId(0);
 
 };
 
@@ -0,0 +1,397 @@
+/**
+ * @file FileReductionAsynchronousOperation.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Reduction (e.g. addition) of the numbers stored in a binary file. The file is split into
+ * chunks which are reduced in parallel by the workers, and the operation completes once with the
+ * aggregated result.
+ */
+
+#ifndef FILEREDUCTIONASYNCHRONOUSOPERATION_H_
+#define FILEREDUCTIONASYNCHRONOUSOPERATION_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../exception/IOException.hpp"
+#include "../exception/OperationNotFinishedException.hpp"
+#include "AsynchronousOperation.hpp"
+
+namespace proactor {
+namespace asyncOperation {
+
+/**
+ * How the chunks of a file are read
+ */
+enum class FileAccessMode {
+	/**
+	 * Each chunk is mapped in memory (with sequential access and read-ahead hints) and unmapped
+	 * once it has been reduced
+	 */
+	MMAP,
+	/**
+	 * Each chunk is read in blocks into an aligned buffer (with sequential access and read-ahead hints)
+	 */
+	STREAM
+};
+
+template <typename T, typename Reduce>
+class FileReductionAsynchronousOperation;
+
+/**
+ * This class is a part of a file reduction: it reduces one chunk of the file and adds its partial
+ * result to the reduction. The completion of the last chunk is dispatched as the completion of
+ * the file reduction.
+ * @see FileReductionAsynchronousOperation
+ */
+template <typename T, typename Reduce>
+class FileChunkAsynchronousOperation : public AsynchronousOperation<T> {
+private:
+	friend class FileReductionAsynchronousOperation<T, Reduce>;
+
+	/**
+	 * Reduction which this chunk belongs to
+	 */
+	FileReductionAsynchronousOperation<T, Reduce>& reduction;
+	/**
+	 * Position of the chunk in the file (in bytes, multiple of the page size)
+	 */
+	const off_t offset;
+	/**
+	 * Length of the chunk (in bytes, multiple of the element size)
+	 */
+	const size_t length;
+	/**
+	 * Error found reducing the chunk (empty if there is none)
+	 */
+	std::string error;
+public:
+	/**
+	 * Constructor
+	 * @param[in] reduction	Reduction which this chunk belongs to
+	 * @param[in] offset	Position of the chunk in the file
+	 * @param[in] length	Length of the chunk
+	 */
+	FileChunkAsynchronousOperation(FileReductionAsynchronousOperation<T, Reduce>& reduction, const off_t offset, const size_t length) :
+		reduction(reduction), offset(offset), length(length) {
+	};
+
+	/**
+	 * Reduce the chunk
+	 */
+	void executeOperation() {
+		error.clear();
+		try {
+			AsynchronousOperation<T>::result = reduction.reduceChunk(offset, length);
+		} catch (exception::IOException& e) {
+			AsynchronousOperation<T>::result = reduction.identity;
+			error = e.getMessage();
+		}
+		AsynchronousOperation<T>::executed = true;
+	};
+
+	/**
+	 * Add the partial result to the reduction and obtain the operation whose completion has to be
+	 * dispatched: the file reduction if this has been the last chunk, or none otherwise. The chunks are
+	 * counted here, and not at the end of their execution, because the processor still uses a chunk
+	 * after executing it: once the last chunk has been counted, the completion of the reduction can be
+	 * dispatched and the client may release it (and its chunks)
+	 */
+	AsynchronousOperation<T>* getCompletedOperation() {
+		return reduction.addPartialResult(AsynchronousOperation<T>::result, error, AsynchronousOperation<T>::startTime) ? &reduction : NULL;
+	};
+
+	/**
+	 * Obtains the partial result of the chunk
+	 * @see exception::OperationNotFinishedException
+	 */
+	T getResult() const {
+		if (AsynchronousOperation<T>::executed)
+			return AsynchronousOperation<T>::result;
+		throw ::proactor::exception::OperationNotFinishedException();
+	};
+};
+
+/**
+ * This class reduces the elements of type T stored in a binary file (in the native representation,
+ * e.g. int64_t or double) with an associative and commutative operation (addition by default).
+ * The memory used does not depend on the size of the file: each worker only maps (or buffers) the
+ * chunk it is reducing.
+ * The chunks are submitted as a batch and only the completion of the reduction is dispatched:
+ *     FileReductionAsynchronousOperation<double> reduction("data.bin");
+ *     initiator.processOperations(reduction.getChunks().begin(), reduction.getChunks().end());
+ * The reduction can also be submitted as a single operation, in which case one worker reduces all
+ * the chunks sequentially. In both cases, the completion handler may release the reduction.
+ * @see FileChunkAsynchronousOperation
+ */
+template <typename T, typename Reduce = std::plus<T> >
+class FileReductionAsynchronousOperation : public AsynchronousOperation<T> {
+private:
+	friend class FileChunkAsynchronousOperation<T, Reduce>;
+
+	/**
+	 * Descriptor of the file
+	 */
+	int fd;
+	/**
+	 * Path of the file
+	 */
+	const std::string path;
+	/**
+	 * How the chunks are read
+	 */
+	const FileAccessMode mode;
+	/**
+	 * Reduction operation
+	 */
+	const Reduce reduce;
+	/**
+	 * Identity element of the reduction operation
+	 */
+	const T identity;
+	/**
+	 * Chunks of the file
+	 */
+	std::vector<std::unique_ptr<FileChunkAsynchronousOperation<T, Reduce> > > chunks;
+	/**
+	 * Chunks of the file, as operations to be submitted
+	 */
+	std::vector<AsynchronousOperation<T>*> chunkOperations;
+	/**
+	 * Lock used to aggregate the partial results
+	 */
+	std::mutex mutex;
+	/**
+	 * Chunks which have not been reduced yet
+	 */
+	size_t remainingChunks;
+	/**
+	 * Description of the first error found reading the file (empty if there is none)
+	 */
+	std::string error;
+
+	/**
+	 * Reduce a buffer of elements
+	 * @param[in] accumulated	Accumulated value
+	 * @param[in] elements		Elements to reduce
+	 * @param[in] count			Number of elements
+	 * @return					Accumulated value after the reduction
+	 */
+	T reduceElements(T accumulated, const T* elements, const size_t count) const {
+		for (size_t i = 0; i < count; ++i)
+			accumulated = reduce(accumulated, elements[i]);
+		return accumulated;
+	};
+
+	/**
+	 * Reduce a chunk of the file
+	 * @param[in] offset	Position of the chunk in the file
+	 * @param[in] length	Length of the chunk
+	 * @return				Partial result
+	 * @throw exception::IOException if the file cannot be read
+	 */
+	T reduceChunk(const off_t offset, const size_t length) const {
+		if (length == 0)
+			return identity;
+		return (mode == FileAccessMode::MMAP) ? reduceMapped(offset, length) : reduceStreamed(offset, length);
+	};
+
+	/**
+	 * Reduce a chunk of the file by mapping it in memory
+	 */
+	T reduceMapped(const off_t offset, const size_t length) const {
+		void* address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, offset);
+		if (address == MAP_FAILED)
+			throw exception::IOException("Cannot map " + path + ": " + std::strerror(errno));
+		// The hints are only advice: their failure is not an error
+		madvise(address, length, MADV_SEQUENTIAL);
+		madvise(address, length, MADV_WILLNEED);
+		const T partial = reduceElements(identity, static_cast<const T*>(address), length / sizeof(T));
+		munmap(address, length);
+		return partial;
+	};
+
+	/**
+	 * Reduce a chunk of the file by reading it in blocks
+	 */
+	T reduceStreamed(const off_t offset, const size_t length) const {
+		posix_fadvise(fd, offset, length, POSIX_FADV_SEQUENTIAL);
+		posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED);
+
+		const size_t blockSize = std::min(STREAM_BLOCK_SIZE, length);
+		void* buffer = NULL;
+		if (posix_memalign(&buffer, BUFFER_ALIGNMENT, blockSize) != 0)
+			throw exception::IOException("Cannot allocate the buffer to read " + path);
+		std::unique_ptr<void, void (*)(void*)> bufferOwner(buffer, std::free);
+
+		T partial = identity;
+		size_t done = 0;
+		while (done < length) {
+			// Fill the block (the reads might be short)
+			const size_t block = std::min(blockSize, length - done);
+			size_t filled = 0;
+			while (filled < block) {
+				const ssize_t bytes = pread(fd, static_cast<char*>(buffer) + filled, block - filled, offset + done + filled);
+				if ((bytes < 0) && (errno == EINTR))
+					continue;
+				if (bytes <= 0)
+					throw exception::IOException("Cannot read " + path + ": " + (bytes < 0 ? std::strerror(errno) : "unexpected end of file"));
+				filled += bytes;
+			}
+			partial = reduceElements(partial, static_cast<const T*>(buffer), block / sizeof(T));
+			done += block;
+		}
+		return partial;
+	};
+
+	/**
+	 * Add the partial result of a chunk
+	 * @param[in] partial	Partial result of the chunk
+	 * @param[in] error		Error found reducing the chunk (empty if there is none)
+	 * @param[in] startTime	Time when the reduction of the chunk started
+	 * @return				True if it was the last chunk (the reduction is then completed)
+	 */
+	bool addPartialResult(const T& partial, const std::string& error, const std::chrono::system_clock::time_point& startTime) {
+		std::lock_guard<std::mutex> locker(mutex);
+		AsynchronousOperation<T>::result = reduce(AsynchronousOperation<T>::result, partial);
+		if (this->error.empty())
+			this->error = error;
+		if ((AsynchronousOperation<T>::startTime == std::chrono::system_clock::time_point()) || (startTime < AsynchronousOperation<T>::startTime))
+			AsynchronousOperation<T>::startTime = startTime;
+		if (--remainingChunks > 0)
+			return false;
+		AsynchronousOperation<T>::endTime = std::chrono::system_clock::now();
+		AsynchronousOperation<T>::executed = true;
+		return true;
+	};
+
+public:
+	/**
+	 * Default size of the chunks (64 MiB)
+	 */
+	static const size_t DEFAULT_CHUNK_SIZE = 64 << 20;
+	/**
+	 * Size of the blocks read in the STREAM mode (1 MiB)
+	 */
+	static const size_t STREAM_BLOCK_SIZE = 1 << 20;
+	/**
+	 * Alignment of the buffer used in the STREAM mode
+	 */
+	static const size_t BUFFER_ALIGNMENT = 4096;
+
+	/**
+	 * Constructor. It opens the file and splits it into chunks
+	 * @param[in] path		Path of the file. If its size is not a multiple of the element size, the
+	 * 						trailing bytes are ignored
+	 * @param[in] mode		How the chunks are read (mapped in memory if it is not defined)
+	 * @param[in] chunkSize	Size of the chunks (in bytes). It is rounded up to a multiple of the page size
+	 * 						and of the element size
+	 * @param[in] reduce	Reduction operation (associative and commutative)
+	 * @param[in] identity	Identity element of the reduction operation
+	 * @throw exception::IOException if the file cannot be opened
+	 */
+	FileReductionAsynchronousOperation(const std::string& path,
+									   const FileAccessMode mode = FileAccessMode::MMAP,
+									   const size_t chunkSize = DEFAULT_CHUNK_SIZE,
+									   const Reduce& reduce = Reduce(),
+									   const T& identity = T()) :
+										   fd(open(path.c_str(), O_RDONLY | O_CLOEXEC)),
+										   path(path),
+										   mode(mode),
+										   reduce(reduce),
+										   identity(identity),
+										   remainingChunks(0) {
+		if (fd < 0)
+			throw exception::IOException("Cannot open " + path + ": " + std::strerror(errno));
+		struct stat status;
+		if (fstat(fd, &status) != 0) {
+			close(fd);
+			throw exception::IOException("Cannot get the size of " + path + ": " + std::strerror(errno));
+		}
+		AsynchronousOperation<T>::result = identity;
+
+		// The offsets of the chunks must be multiples of the page size (to be mapped) and of the element size
+		const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		const size_t unit = (pageSize % sizeof(T) == 0) ? pageSize : pageSize * sizeof(T);
+		const size_t size = static_cast<size_t>(status.st_size) - static_cast<size_t>(status.st_size) % sizeof(T);
+		const size_t chunk = std::max<size_t>((chunkSize + unit - 1) / unit, 1) * unit;
+		size_t offset = 0;
+		do {
+			const size_t length = std::min(chunk, size - offset);
+			chunks.push_back(std::unique_ptr<FileChunkAsynchronousOperation<T, Reduce> >(
+					new FileChunkAsynchronousOperation<T, Reduce>(*this, static_cast<off_t>(offset), length)));
+			chunkOperations.push_back(chunks.back().get());
+			offset += length;
+		} while (offset < size);
+		remainingChunks = chunks.size();
+	};
+
+	/**
+	 * Class destructor
+	 */
+	~FileReductionAsynchronousOperation() {
+		close(fd);
+	};
+
+	/**
+	 * Obtain the chunks of the file, to be submitted as a batch. The completion of the last one is
+	 * dispatched as the completion of this operation
+	 * @return	Chunks of the file
+	 */
+	const std::vector<AsynchronousOperation<T>*>& getChunks() const {
+		return chunkOperations;
+	};
+
+	/**
+	 * Reduce all the chunks sequentially (when the reduction is submitted as a single operation)
+	 */
+	void executeOperation() {
+		T accumulated = identity;
+		try {
+			for (const std::unique_ptr<FileChunkAsynchronousOperation<T, Reduce> >& chunk : chunks)
+				accumulated = reduce(accumulated, reduceChunk(chunk->offset, chunk->length));
+		} catch (exception::IOException& e) {
+			error = e.getMessage();
+		}
+		AsynchronousOperation<T>::result = accumulated;
+		AsynchronousOperation<T>::executed = true;
+	};
+
+	/**
+	 * Obtains the result of the reduction, or an exception in case it has not finished
+	 * @return	Result of the reduction
+	 * @throw exception::OperationNotFinishedException if the reduction has not finished
+	 * @throw exception::IOException if the file could not be read
+	 */
+	T getResult() const {
+		if (!AsynchronousOperation<T>::executed)
+			throw ::proactor::exception::OperationNotFinishedException();
+		if (!error.empty())
+			throw ::proactor::exception::IOException(error);
+		return AsynchronousOperation<T>::result;
+	};
+};
+
+template <typename T, typename Reduce>
+const size_t FileReductionAsynchronousOperation<T, Reduce>::DEFAULT_CHUNK_SIZE;
+template <typename T, typename Reduce>
+const size_t FileReductionAsynchronousOperation<T, Reduce>::STREAM_BLOCK_SIZE;
+template <typename T, typename Reduce>
+const size_t FileReductionAsynchronousOperation<T, Reduce>::BUFFER_ALIGNMENT;
+
+}
+}
+
+#endif /* FILEREDUCTIONASYNCHRONOUSOPERATION_H_ */
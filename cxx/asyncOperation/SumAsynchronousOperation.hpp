@@ -6,7 +6,12 @@
  */
 
 
+#include <limits>
 #include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
 
 #include "../exception/OperationNotFinishedException.hpp"
 #include "AsynchronousOperation.hpp"
@@ -35,8 +40,7 @@ public:
 	 * Constructor
 	 * @param[in] numbers	Elements that take part of the computation
 	 */
-	SumAsynchronousOperation(std::list<T> numbers) {
-		elements = numbers;
+	SumAsynchronousOperation(std::list<T> numbers) : elements(std::move(numbers)) {
 		// Indicate that the result, should the operation has been calculated, is not updated
 		AsynchronousOperation<T>::executed = false;
 	}
@@ -56,6 +60,28 @@ public:
 	SumAsynchronousOperation(T element1, T element2) : SumAsynchronousOperation(std::list<T>({element1,element2})) {
 	};
 
+	/**
+	 * Name under which the type of the operation is registered
+	 */
+	static std::string typeName() {
+		return "sum";
+	};
+
+	/**
+	 * Create an operation from its serialized arguments
+	 * @param[in] arguments	Serialized arguments (elements separated by spaces)
+	 * @return				New operation (the caller takes the ownership)
+	 * @see serializeArguments
+	 */
+	static SumAsynchronousOperation<T>* deserialize(const std::string& arguments) {
+		std::list<T> numbers;
+		std::istringstream stream(arguments);
+		T number;
+		while (stream >> number)
+			numbers.push_back(number);
+		return new SumAsynchronousOperation<T>(std::move(numbers));
+	};
+
 	/**
 	 * Class destructor
 	 */
@@ -77,11 +103,37 @@ public:
 		// this line because it will make the pattern run slowly. However, it is added here
 		// to verify the behavior with different threads and operations
 		// (maximum sleep time: 9.999 seconds)
-		std::this_thread::sleep_for(std::chrono::milliseconds(std::rand() % 10000));
+		std::uniform_int_distribution<int> sleepTime(0, 9999);
+		std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime(utils::Utils::randomGenerator())));
 
 		AsynchronousOperation<T>::executed = true;
 	}
 
+	/**
+	 * Obtain the name under which the type of the operation is registered
+	 */
+	std::string getTypeName() const {
+		return typeName();
+	};
+
+	/**
+	 * Serialize the elements of the operation (separated by spaces, with full precision)
+	 */
+	std::string serializeArguments() const {
+		std::ostringstream stream;
+		stream.precision(std::numeric_limits<T>::max_digits10);
+		for (const T& element : elements)
+			stream << element << ' ';
+		return stream.str();
+	};
+
+	/**
+	 * Obtain the content key of the operation: the addition is pure, so it is given by its elements
+	 */
+	std::string getContentKey() const {
+		return typeName() + ':' + serializeArguments();
+	};
+
 	/**
 	 * Obtains the result of the computation, or an exception in case the computation
 	 * has not been done
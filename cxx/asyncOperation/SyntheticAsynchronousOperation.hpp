@@ -0,0 +1,152 @@
+/**
+ * @file SyntheticAsynchronousOperation.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Synthetic operation whose only work is to spend a service time, either using
+ * the CPU or sleeping. It is used to generate load.
+ */
+
+#ifndef SYNTHETICASYNCHRONOUSOPERATION_H_
+#define SYNTHETICASYNCHRONOUSOPERATION_H_
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "../exception/OperationNotFinishedException.hpp"
+#include "../utils/ServiceTimeDistribution.hpp"
+#include "../utils/Utils.hpp"
+#include "AsynchronousOperation.hpp"
+
+namespace proactor {
+namespace asyncOperation {
+
+/**
+ * How a synthetic operation spends its service time
+ */
+enum class ServiceMode {
+	/**
+	 * Busy loop (CPU-bound operation)
+	 */
+	SPIN,
+	/**
+	 * Sleep (I/O-bound operation)
+	 */
+	SLEEP
+};
+
+/**
+ * This class represents a synthetic operation. Its service time is drawn from a distribution
+ * when it is executed, with the random number generator of the worker thread. The result of
+ * the operation is the service time (in nanoseconds).
+ * @see AsynchronousOperation
+ * @see utils::ServiceTimeDistribution
+ */
+template<typename T>
+class SyntheticAsynchronousOperation : public AsynchronousOperation<T> {
+private:
+	/**
+	 * Distribution of the service time
+	 */
+	const utils::ServiceTimeDistribution distribution;
+	/**
+	 * How the service time is spent
+	 */
+	const ServiceMode mode;
+public:
+	/**
+	 * Constructor
+	 * @param[in] distribution	Distribution of the service time
+	 * @param[in] mode			How the service time is spent
+	 */
+	SyntheticAsynchronousOperation(const utils::ServiceTimeDistribution& distribution, const ServiceMode mode) :
+		distribution(distribution), mode(mode) {
+	};
+
+	/**
+	 * Obtain the distribution of the service time
+	 */
+	const utils::ServiceTimeDistribution& getDistribution() const {
+		return distribution;
+	};
+
+	/**
+	 * Obtain how the service time is spent
+	 */
+	ServiceMode getServiceMode() const {
+		return mode;
+	};
+
+	/**
+	 * Name under which the type of the operation is registered
+	 */
+	static std::string typeName() {
+		return "synthetic";
+	};
+
+	/**
+	 * Create an operation from its serialized arguments
+	 * @param[in] arguments	Serialized arguments (specification of the distribution and mode)
+	 * @return				New operation (the caller takes the ownership)
+	 * @throw std::invalid_argument if the arguments are not valid
+	 * @see serializeArguments
+	 */
+	static SyntheticAsynchronousOperation<T>* deserialize(const std::string& arguments) {
+		const size_t separator = arguments.find(' ');
+		if (separator == std::string::npos)
+			throw std::invalid_argument("Invalid synthetic operation: " + arguments);
+		const std::string modeName = arguments.substr(separator + 1);
+		if ((modeName != "spin") && (modeName != "sleep"))
+			throw std::invalid_argument("Invalid service mode of a synthetic operation: " + modeName);
+		const ServiceMode mode = (modeName == "spin") ? ServiceMode::SPIN : ServiceMode::SLEEP;
+		return new SyntheticAsynchronousOperation<T>(utils::ServiceTimeDistribution::parse(arguments.substr(0, separator)), mode);
+	};
+
+	/**
+	 * Obtain the name under which the type of the operation is registered
+	 */
+	std::string getTypeName() const {
+		return typeName();
+	};
+
+	/**
+	 * Serialize the distribution of the service time and the mode
+	 */
+	std::string serializeArguments() const {
+		return distribution.toString() + ((mode == ServiceMode::SPIN) ? " spin" : " sleep");
+	};
+
+	/**
+	 * Spend the service time
+	 */
+	void executeOperation() {
+		const std::chrono::nanoseconds serviceTime = distribution.sample(utils::Utils::randomGenerator());
+		if (mode == ServiceMode::SLEEP) {
+			std::this_thread::sleep_for(serviceTime);
+		} else {
+			const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + serviceTime;
+			while (std::chrono::steady_clock::now() < end) {
+				// Busy loop
+			}
+		}
+		AsynchronousOperation<T>::result = static_cast<T>(serviceTime.count());
+		AsynchronousOperation<T>::executed = true;
+	};
+
+	/**
+	 * Obtains the service time of the operation
+	 * @return	Service time (in nanoseconds)
+	 * @see exception::OperationNotFinishedException
+	 */
+	T getResult() const {
+		if (AsynchronousOperation<T>::executed)
+			return AsynchronousOperation<T>::result;
+		throw ::proactor::exception::OperationNotFinishedException();
+	};
+};
+
+}
+}
+
+#endif /* SYNTHETICASYNCHRONOUSOPERATION_H_ */
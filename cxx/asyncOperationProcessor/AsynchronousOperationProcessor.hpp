@@ -7,52 +7,329 @@
 #ifndef ASYNCHRONOUSOPERATIONPROCESSOR_H_
 #define ASYNCHRONOUSOPERATIONPROCESSOR_H_
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <future>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
-#include <deque>
+#include <unordered_map>
+#include <vector>
 #include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../cache/ResultCache.hpp"
 #include "../completionEventQueue/CompletionEventQueue.hpp"
+#include "../concurrencyController/ConcurrencyController.hpp"
+#include "../exception/ShutdownException.hpp"
+#include "../executor/SharedExecutor.hpp"
 #include "../logger/Logger.hpp"
 #include "../observer/Observer.hpp"
+#include "../operationTable/OperationTable.hpp"
+#include "../policy/Policies.hpp"
+#include "../trace/TraceRecorder.hpp"
+#include "../utils/RingBuffer.hpp"
+#include "../watchdog/Watchdog.hpp"
 
 namespace proactor {
 namespace asyncOperationProcessor  {
 
+/**
+ * Counters of the deduplication of operations
+ */
+struct DeduplicationStatistics {
+	/**
+	 * Operations completed with a cached result
+	 */
+	uint64_t hits;
+	/**
+	 * Operations with a content key which have been executed
+	 */
+	uint64_t misses;
+	/**
+	 * Operations attached to the execution of an equivalent operation
+	 */
+	uint64_t coalesced;
+};
+
 /**
  * This class represents the asynchronous operation processor:
  * It places asynchronous operations in the execution queue, executes the
  * operations from the queue and, once the operation has finished, it queues
  * the corresponding completion events.
+ * The operations are executed by its own workers or, if it is given a shared executor, by the threads
+ * of the executor (one task per ready operation).
+ * @tparam Policies	Configuration of the engine: synchronization (Locking), threads which execute the
+ * 					operations (Executor), messages of the executed operations (Logging) and collected
+ * 					metrics (Metrics)
  */
-template <typename T>
-class AsynchronousOperationProcessor : public observer::Observer<asyncOperation::AsynchronousOperation<T> > {
+template <typename T, typename Policies = policy::DefaultPolicies>
+class AsynchronousOperationProcessor : public observer::Observer<asyncOperation::AsynchronousOperation<T> >,
+									   public executor::TaskSource {
 private:
+	typedef typename Policies::Locking::Mutex Mutex;
+	typedef typename Policies::Locking::ConditionVariable ConditionVariable;
 	/**
 	 * Maximum pool size
 	 */
 	size_t poolSize;
+	/**
+	 * Current concurrency limit: maximum number of non-completed operations. It is equal to the pool
+	 * size unless a concurrency controller adapts it
+	 */
+	size_t limit;
+	/**
+	 * Controller which adapts the concurrency limit at runtime (optional)
+	 */
+	std::shared_ptr<concurrencyController::ConcurrencyController> controller;
+	/**
+	 * Watchdog of the workers (optional)
+	 */
+	std::shared_ptr<watchdog::Watchdog> stallWatchdog;
+	/**
+	 * Shared executor which executes the operations instead of the workers (optional)
+	 */
+	std::shared_ptr<executor::SharedExecutor> sharedExecutor;
+	/**
+	 * Registration of the processor in the shared executor
+	 */
+	executor::SharedExecutor::Client* executorClient;
 	/**
 	 * Mutex used to control the insertion in the non-completed operations queue
 	 */
-	std::mutex lock;
+	Mutex lock;
 	/**
 	 * Condition variable used to control the insertion regarding the queue size
 	 */
-	std::condition_variable cv;
+	ConditionVariable cv;
+	/**
+	 * Condition variable used to wake up the workers when there are operations ready to be executed
+	 */
+	ConditionVariable workCv;
 	/**
 	 * Pool of non-completed operations
 	 */
-	std::deque<asyncOperation::AsynchronousOperation<T>*> pool;
+	operationTable::OperationTable<T> pool;
+	/**
+	 * Operations accepted in the pool which have not been picked up by a worker yet
+	 */
+	utils::RingBuffer<asyncOperation::AsynchronousOperation<T>*> ready;
+	/**
+	 * Threads which execute the operations. There is one worker per slot in the pool, so an
+	 * accepted operation never waits for a worker
+	 */
+	std::vector<std::thread> workers;
+	/**
+	 * Indicates that the workers have to finish
+	 */
+	bool stopWorkers;
+	/**
+	 * Indicates that no more operations are accepted
+	 */
+	bool closed;
 	/**
 	 * Pool of completed operations (completed)
 	 */
-	std::shared_ptr<completionEventQueue::CompletionEventQueue<T> > completionEventQueue;
+	std::shared_ptr<completionEventQueue::CompletionEventQueue<T, Policies> > completionEventQueue;
+	/**
+	 * Handler invoked directly in the worker thread for the operations completed inline
+	 */
+	observer::Observer<asyncOperation::AsynchronousOperation<T> >* completionHandler;
+	/**
+	 * Completion mode used for the operations which do not define their own one
+	 */
+	asyncOperation::CompletionMode defaultCompletionMode;
+	/**
+	 * Metrics of the processed operations
+	 */
+	typename Policies::Metrics metrics;
+	/**
+	 * Indicates whether the operations with a content key are deduplicated
+	 */
+	bool deduplication;
+	/**
+	 * Results of the last executed operations with a content key (optional)
+	 */
+	std::unique_ptr<cache::ResultCache<T> > resultCache;
+	/**
+	 * Operations attached to each operation being executed, indexed by the content key
+	 */
+	std::unordered_map<std::string, std::vector<asyncOperation::AsynchronousOperation<T>*> > inFlight;
+	/**
+	 * Content key of the operations being executed which may have attached operations
+	 */
+	std::unordered_map<const asyncOperation::AsynchronousOperation<T>*, std::string> leaderKeys;
+	/**
+	 * Counters of the deduplication
+	 */
+	DeduplicationStatistics deduplicationStatistics;
+
+	/**
+	 * Try to complete an operation without executing it: with the cached result or by attaching it to
+	 * an equivalent operation being executed. Otherwise, the operation has to be executed. It must be
+	 * called with the lock held
+	 * @param[in] operation		Operation
+	 * @param[in] key			Content key of the operation
+	 * @param[out] completions	The operation is added if it has been completed with the cached result
+	 * @return					True if the operation does not have to be executed
+	 */
+	bool deduplicate(asyncOperation::AsynchronousOperation<T>* operation, const std::string& key,
+					 std::vector<asyncOperation::AsynchronousOperation<T>*>& completions) {
+		typename std::unordered_map<std::string, std::vector<asyncOperation::AsynchronousOperation<T>*> >::iterator flight = inFlight.find(key);
+		if (flight != inFlight.end()) {
+			flight->second.push_back(operation);
+			++deduplicationStatistics.coalesced;
+			return true;
+		}
+		T value;
+		if (resultCache && resultCache->get(key, value)) {
+			operation->completeWith(value);
+			completions.push_back(operation);
+			++deduplicationStatistics.hits;
+			return true;
+		}
+		return false;
+	};
+
+	/**
+	 * Detach the operations attached to an executed operation and complete them with its result, which
+	 * is cached. If the result is not available (the operation has failed), the attached operations
+	 * are executed on their own, even beyond the concurrency limit. It must be called with the lock held
+	 * @param[in] operation		Executed operation
+	 * @param[out] completions	Operations to be dispatched
+	 */
+	void completeAttached(asyncOperation::AsynchronousOperation<T>* operation,
+						  std::vector<asyncOperation::AsynchronousOperation<T>*>& completions) {
+		typename std::unordered_map<const asyncOperation::AsynchronousOperation<T>*, std::string>::iterator leader = leaderKeys.find(operation);
+		if (leader == leaderKeys.end())
+			return;
+		const std::string key = leader->second;
+		leaderKeys.erase(leader);
+		completions.swap(inFlight[key]);
+		inFlight.erase(key);
+
+		T value;
+		try {
+			value = operation->getResult();
+		} catch (std::exception&) {
+			const int64_t submitted = operationTable::OperationTable<T>::now();
+			for (asyncOperation::AsynchronousOperation<T>* attached : completions) {
+				pool.insert(attached, submitted);
+				ready.push_back(attached);
+			}
+			wakeWorkers(completions.size());
+			completions.clear();
+			return;
+		}
+		if (resultCache)
+			resultCache->put(key, value);
+		for (asyncOperation::AsynchronousOperation<T>* attached : completions)
+			attached->completeWith(value);
+	};
+
+	/**
+	 * Dispatch the completion of a set of operations. It must be called with the lock held, which is
+	 * released (the handlers of the inline completions are invoked without it)
+	 * @param[in] completions	Completed operations. The vector is modified
+	 * @param[in] locker		Lock of the processor
+	 */
+	void dispatch(std::vector<asyncOperation::AsynchronousOperation<T>*>& completions, std::unique_lock<Mutex>& locker) {
+		size_t inlineCompletions = 0;
+		for (asyncOperation::AsynchronousOperation<T>* completed : completions) {
+			if (isInlineCompletion(completed)) {
+				completions[inlineCompletions++] = completed;
+			} else {
+				trace::traceEvent(trace::TraceEvent::ENQUEUE_COMPLETION, completed->getId());
+				completionEventQueue->push(completed);
+			}
+		}
+		locker.unlock();
+		for (size_t i = 0; i < inlineCompletions; ++i) {
+			completionHandler->notify(completions[i]);
+			completionEventQueue->decrementPendingOperations();
+		}
+	};
+
+	/**
+	 * Decide whether the completion of an operation is handled inline or through the
+	 * completion event queue
+	 * @param[in] operation	Completed operation
+	 * @return				True if the completion handler has to be invoked in the current thread
+	 */
+	bool isInlineCompletion(const asyncOperation::AsynchronousOperation<T> *operation) const {
+		if (completionHandler == NULL)
+			return false;
+		// There is no other thread to dispatch the completion
+		if (Policies::Executor::CALLER_THREAD)
+			return true;
+		asyncOperation::CompletionMode mode = operation->getCompletionMode();
+		if (mode == asyncOperation::CompletionMode::ENGINE_DEFAULT)
+			mode = defaultCompletionMode;
+		return mode == asyncOperation::CompletionMode::INLINE;
+	};
+
+	/**
+	 * Wake up a worker per ready operation (or submit them to the shared executor). It must be called
+	 * with the lock held
+	 * @param[in] count	Number of new ready operations
+	 */
+	void wakeWorkers(const size_t count) {
+		if (executorClient)
+			sharedExecutor->submit(executorClient, count);
+		else if (count == 1)
+			workCv.notify_one();
+		else if (count > 1)
+			workCv.notify_all();
+	};
+
+	/**
+	 * Execute the first ready operation. It must be called with the lock held, which is released
+	 * while the operation is executed (its completion calls notify)
+	 * @param[in] locker	Lock of the processor
+	 * @param[in] slot		Slot where the activity of the thread is published (NULL if it is not watched)
+	 */
+	void executeNext(std::unique_lock<Mutex>& locker, watchdog::ActivitySlot* slot) {
+		asyncOperation::AsynchronousOperation<T>* operation = ready.front();
+		ready.pop_front();
+		pool.markRunning(operation, operationTable::OperationTable<T>::now());
+		locker.unlock();
+		if (slot)
+			slot->begin(operation->getId());
+		operation->template execute<typename Policies::Logging>();
+		if (slot)
+			slot->end();
+		locker.lock();
+	};
+
+	/**
+	 * Execute the ready operations in the calling thread (with the CallerThreadExecutor). It must
+	 * be called with the lock held, which is released while each operation is executed
+	 * @param[in] locker	Lock of the processor
+	 */
+	void executeReady(std::unique_lock<Mutex>& locker) {
+		while (!ready.empty())
+			executeNext(locker, NULL);
+	};
+
+	/**
+	 * Main loop of the workers: it waits for ready operations and executes them
+	 */
+	void work() {
+		trace::traceThreadName("worker");
+		watchdog::ActivitySlot* slot = stallWatchdog ? stallWatchdog->registerThread(watchdog::StallKind::OPERATION, "worker") : NULL;
+		std::unique_lock<Mutex> locker(lock);
+		while (true) {
+			workCv.wait(locker, [&]{ return stopWorkers || !ready.empty();});
+			if (ready.empty())
+				break;
+			executeNext(locker, slot);
+		}
+		if (slot)
+			stallWatchdog->unregisterThread(slot);
+	};
 public:
 	/**
 	 * Default queue size for the non-completed operations, in case it is not defined
@@ -64,18 +341,84 @@ public:
 	 * @param[in] completionEventQueue	Queue of processed and completed operations.
 	 * @param[in] poolSize				Maximum size of the queue for non-completed operations. This parameter is optional (if it
 	 * 									it not defined, the DEFAULT_QUEUE_SIZE is set instead)
+	 * @param[in] completionHandler		Handler invoked in the worker thread for the operations completed inline. If
+	 * 									it is not defined, all the completions go through the completion event queue
+	 * @param[in] defaultCompletionMode	Completion mode for the operations which do not define their own one
+	 * @param[in] controller			Controller which adapts the concurrency limit at runtime. If it is defined, the
+	 * 									pool size is given by its maximum limit
+	 * @param[in] watchdog				Watchdog which reports the operations executing for too long. The workers
+	 * 									are not watched if it is not defined
+	 * @param[in] executor				Shared executor which executes the operations. If it is defined, the processor
+	 * 									does not start its own workers (the threads of the executor are watched
+	 * 									by the watchdog of the executor)
 	 */
-	AsynchronousOperationProcessor( std::shared_ptr<completionEventQueue::CompletionEventQueue<T> >& completionEventQueue,
-									const size_t poolSize = DEFAULT_QUEUE_SIZE) :
-										poolSize(poolSize),
-										pool(std::deque<asyncOperation::AsynchronousOperation<T>*>()),
-										completionEventQueue(completionEventQueue) {
+	AsynchronousOperationProcessor( std::shared_ptr<completionEventQueue::CompletionEventQueue<T, Policies> >& completionEventQueue,
+									const size_t poolSize = DEFAULT_QUEUE_SIZE,
+									observer::Observer<asyncOperation::AsynchronousOperation<T> >* completionHandler = NULL,
+									const asyncOperation::CompletionMode defaultCompletionMode = asyncOperation::CompletionMode::SERIALIZED,
+									const std::shared_ptr<concurrencyController::ConcurrencyController>& controller = nullptr,
+									const std::shared_ptr<watchdog::Watchdog>& watchdog = nullptr,
+									const std::shared_ptr<executor::SharedExecutor>& executor = nullptr) :
+										poolSize(controller ? controller->getMaxLimit() : poolSize),
+										limit(controller ? controller->getInitialLimit() : poolSize),
+										controller(controller),
+										stallWatchdog(watchdog),
+										sharedExecutor(executor),
+										executorClient(NULL),
+										pool(this->poolSize),
+										ready(this->poolSize),
+										stopWorkers(false),
+										closed(false),
+										completionEventQueue(completionEventQueue),
+										completionHandler(completionHandler),
+										defaultCompletionMode(defaultCompletionMode),
+										deduplication(false),
+										deduplicationStatistics() {
+		// Start the workers (none if the operations are executed by the caller or the shared executor)
+		if (Policies::Executor::CALLER_THREAD)
+			return;
+		if (executor)
+			executorClient = executor->attach(this, watchdog::StallKind::OPERATION, 1, this->poolSize);
+		else
+			for (size_t i = 0; i < this->poolSize; ++i)
+				workers.push_back(std::thread(&AsynchronousOperationProcessor<T, Policies>::work, this));
 	};
 
 	/**
-	 * Class destructor
+	 * Class destructor. It waits for the workers, which finish once the ready operations
+	 * have been executed
 	 */
 	virtual ~AsynchronousOperationProcessor() {
+		{
+			std::lock_guard<Mutex> locker(lock);
+			stopWorkers = true;
+		}
+		workCv.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+		if (executorClient)
+			sharedExecutor->detach(executorClient);
+	};
+
+	/**
+	 * Execute the next ready operation (a task of the shared executor)
+	 * @param[in] slot	Slot where the activity of the thread is published (NULL if it is not watched)
+	 */
+	void runTask(watchdog::ActivitySlot* slot) {
+		std::unique_lock<Mutex> locker(lock);
+		// The operation may have been discarded by abortPending
+		if (!ready.empty())
+			executeNext(locker, slot);
+	};
+
+	/**
+	 * Set the share of the threads of the shared executor given to this processor, relative to the
+	 * other processors which share it (1 by default)
+	 * @param[in] weight	Operations executed per turn
+	 */
+	void setExecutorWeight(const unsigned int weight) {
+		if (executorClient)
+			sharedExecutor->setWeight(executorClient, weight);
 	};
 
 	/**
@@ -83,24 +426,176 @@ public:
 	 * @param[in] operation	Operation to be added to the queue and to be executed
 	 */
 	void addOperation(asyncOperation::AsynchronousOperation<T>* operation) {
+		addOperations(&operation, &operation + 1);
+	};
+
+	/**
+	 * Add a set of operations to the execution queue. The operations are accepted in rounds (as
+	 * many as free slots in the pool), so the lock is taken, the pending operations counter updated
+	 * and the workers woken up once per round instead of once per operation.
+	 * If the processor is closed while waiting for a slot, the operations accepted in the previous rounds
+	 * are still executed.
+	 * With deduplication, the operations completed with a cached result or attached to an equivalent
+	 * operation do not take a slot.
+	 * @param[in] begin	Iterator to the first operation to be added (AsynchronousOperation<T>*)
+	 * @param[in] end	Iterator past the last operation to be added
+	 * @throw exception::ShutdownException if the processor has been closed
+	 */
+	template <typename Iterator>
+	void addOperations(Iterator begin, Iterator end) {
+		const std::chrono::system_clock::time_point submitTime = std::chrono::system_clock::now();
+		const int64_t submitted = operationTable::OperationTable<T>::now();
+		// Operations completed with a cached result
+		std::vector<asyncOperation::AsynchronousOperation<T>*> cached;
 		// Lock the queue
-		std::unique_lock<std::mutex> locker(lock);
-		// Wait until there is some slot free in the execution queue
-		if (pool.size() == poolSize)
-			cv.wait(locker, [&]{ return pool.size() < poolSize;});
+		std::unique_lock<Mutex> locker(lock);
+		while (begin != end) {
+			// Wait until there is some slot free in the execution queue (the first operation may not need it)
+			if ((pool.size() >= limit) && !deduplication)
+				cv.wait(locker, [&]{ return closed || pool.size() < limit;});
+			if (closed)
+				throw exception::ShutdownException();
+
+			// Accept as many operations as free slots
+			size_t accepted = 0, started = 0;
+			for (; begin != end; ++begin, ++accepted) {
+				asyncOperation::AsynchronousOperation<T>* operation = *begin;
+				std::string key;
+				if (deduplication) {
+					key = operation->getContentKey();
+					if (!key.empty() && deduplicate(operation, key, cached)) {
+						operation->setObserver(this);
+						operation->setSubmitTime(submitTime);
+						trace::traceEvent(trace::TraceEvent::SUBMIT, operation->getId());
+						continue;
+					}
+				}
+				if (pool.size() >= limit)
+					break;
+				if (!key.empty()) {
+					// The operation is executed: the equivalent ones will be attached to it
+					inFlight[key];
+					leaderKeys[operation] = key;
+					++deduplicationStatistics.misses;
+				}
+				operation->setSubmitTime(submitTime);
+				trace::traceEvent(trace::TraceEvent::SUBMIT, operation->getId());
+				// Set this class as the observer of the operation
+				operation->setObserver(this);
+				// Put the operation to the execution queue
+				pool.insert(operation, submitted);
+				ready.push_back(operation);
+				++started;
+			}
+
+			// Update the counter of operations being processed and not terminated
+			if (accepted > 0) {
+				completionEventQueue->incrementPendingOperations(accepted);
+				metrics.onAccepted(accepted);
+			}
+
+			// Wake up a worker per started operation, or execute them in this thread
+			if (Policies::Executor::CALLER_THREAD)
+				executeReady(locker);
+			else
+				wakeWorkers(started);
+
+			if (!cached.empty()) {
+				dispatch(cached, locker);
+				cached.clear();
+				locker.lock();
+			}
+			// Wait for a slot for the next operation
+			if ((begin != end) && deduplication)
+				cv.wait(locker, [&]{ return closed || pool.size() < limit;});
+		}
+	};
 
-		// Set this class as the observer of the operation
-		operation->setObserver(this);
+	/**
+	 * Enable the deduplication of the operations with a content key: an operation equivalent to one
+	 * being executed is attached to it and completed with its result, and, if the cache is enabled, an
+	 * operation whose result is cached is completed immediately. In both cases, the operation is not
+	 * executed and its completion is dispatched as usual. It must be set before adding operations.
+	 * @param[in] enabled		Indicates whether the operations are deduplicated
+	 * @param[in] cacheCapacity	Maximum number of cached results (0 disables the cache)
+	 * @see asyncOperation::AsynchronousOperation::getContentKey
+	 */
+	void setDeduplication(const bool enabled, const size_t cacheCapacity = 0) {
+		std::lock_guard<Mutex> locker(lock);
+		deduplication = enabled;
+		resultCache.reset((enabled && (cacheCapacity > 0)) ? new cache::ResultCache<T>(cacheCapacity) : NULL);
+	};
 
-		// Update the counter of operations being processed and not terminated
-		completionEventQueue->incrementPendingOperations();
+	/**
+	 * Obtain the metrics of the processed operations
+	 * @see policy::MetricsPolicy
+	 */
+	const typename Policies::Metrics& getMetrics() const {
+		return metrics;
+	};
+
+	/**
+	 * Obtain the counters of the deduplication
+	 */
+	DeduplicationStatistics getDeduplicationStatistics() {
+		std::lock_guard<Mutex> locker(lock);
+		return deduplicationStatistics;
+	};
 
-		// Start the operation in a new thread
-		std::thread t = std::thread(&asyncOperation::AsynchronousOperation<T>::execute, operation);
-		t.detach();
+	/**
+	 * Summarize the non-completed operations: how many are queued and running, and since when
+	 */
+	operationTable::InFlightStatistics getInFlightStatistics() {
+		std::lock_guard<Mutex> locker(lock);
+		return pool.getStatistics(operationTable::OperationTable<T>::now());
+	};
 
-		// Put the operation to the execution queue
-		pool.push_back(operation);
+	/**
+	 * Obtain the current concurrency limit (maximum number of non-completed operations)
+	 * @return	Concurrency limit
+	 */
+	size_t getConcurrencyLimit() {
+		std::lock_guard<Mutex> locker(lock);
+		return limit;
+	};
+
+	/**
+	 * Stop accepting operations. The operations which are waiting for a free slot are rejected
+	 * and the subsequent ones too.
+	 */
+	void close() {
+		{
+			std::lock_guard<Mutex> locker(lock);
+			closed = true;
+		}
+		cv.notify_all();
+	};
+
+	/**
+	 * Discard the accepted operations which have not been started by a worker yet. They are
+	 * neither executed nor notified. The operations being executed are not affected.
+	 * @return	Number of discarded operations
+	 */
+	size_t abortPending() {
+		std::lock_guard<Mutex> locker(lock);
+		size_t aborted = ready.size();
+		for (size_t i = 0; i < ready.size(); ++i) {
+			asyncOperation::AsynchronousOperation<T>* operation = ready[i];
+			pool.erase(operation);
+			// The operations attached to a discarded operation are discarded too
+			typename std::unordered_map<const asyncOperation::AsynchronousOperation<T>*, std::string>::iterator leader = leaderKeys.find(operation);
+			if (leader != leaderKeys.end()) {
+				aborted += inFlight[leader->second].size();
+				inFlight.erase(leader->second);
+				leaderKeys.erase(leader);
+			}
+		}
+		ready.clear();
+		if (aborted > 0) {
+			completionEventQueue->decrementPendingOperations(aborted);
+			cv.notify_all();
+		}
+		return aborted;
 	};
 
 	/**
@@ -109,26 +604,66 @@ public:
 	 * @param[in] operation	Completed operation
 	 */
 	void notify(asyncOperation::AsynchronousOperation<T> *operation) {
+		metrics.onExecuted(operation);
+
 		// Lock the queue
-		std::unique_lock<std::mutex> locker(lock);
+		std::unique_lock<Mutex> locker(lock);
 
-		// Add the operation to the completion event queue
-		completionEventQueue->push(operation);
+		// Adapt the concurrency limit. This is done before dispatching the completion, as the client
+		// may release the operation afterwards
+		const size_t previousLimit = limit;
+		if (controller)
+			limit = controller->onCompletion(limit, pool.size(),
+					std::chrono::duration_cast<std::chrono::nanoseconds>(operation->getStartTime() - operation->getSubmitTime()),
+					std::chrono::duration_cast<std::chrono::nanoseconds>(operation->getEndTime() - operation->getStartTime()));
 
 		// Remove the operation from the execution pool, if it exists
-		bool isFull = false;
-		typedef typename std::deque<asyncOperation::AsynchronousOperation<T>*>::iterator iterType;
-		iterType iter = std::find(pool.begin(), pool.end(), operation);
-		if (iter != pool.end()) {
-			isFull = pool.size() == poolSize;
-			pool.erase(iter);
-		}
-		// Unlock the next waiting operation
-		if (isFull)
+		pool.erase(operation);
+
+		// Unlock the next waiting operation (or all of them if the limit has been raised). Each free
+		// slot wakes up a waiting thread, even if the pool was not full: otherwise, a slot released
+		// before the previously woken thread takes its own one would be lost
+		if (limit > previousLimit)
+			cv.notify_all();
+		else if (pool.size() < limit)
 			cv.notify_one();
+
+		// Complete the operations attached to this one
+		std::vector<asyncOperation::AsynchronousOperation<T>*> attached;
+		if (!leaderKeys.empty())
+			completeAttached(operation, attached);
+
+		// Operation whose completion has to be dispatched (none for the parts of a composite operation
+		// which are not the last one). It is obtained once this method does not use the executed
+		// operation anymore: the part which completes a composite operation may be released with it
+		asyncOperation::AsynchronousOperation<T>* completed = operation->getCompletedOperation();
+		const bool inlineCompletion = (completed != NULL) && isInlineCompletion(completed);
+		if (completed == NULL) {
+			// Nothing to dispatch: the operation is terminated
+			completionEventQueue->decrementPendingOperations();
+		} else if (!inlineCompletion) {
+			// Add the operation to the completion event queue
+			trace::traceEvent(trace::TraceEvent::ENQUEUE_COMPLETION, completed->getId());
+			completionEventQueue->push(completed);
+		} else {
+			// Invoke the handler in this thread, without holding the lock. The operation is only
+			// considered terminated once the handler has returned
+			locker.unlock();
+			completionHandler->notify(completed);
+			completionEventQueue->decrementPendingOperations();
+		}
+
+		if (!attached.empty()) {
+			if (!locker.owns_lock())
+				locker.lock();
+			dispatch(attached, locker);
+		}
 	};
 };
 
+template <typename T, typename Policies>
+const size_t AsynchronousOperationProcessor<T, Policies>::DEFAULT_QUEUE_SIZE;
+
 }
 }
 
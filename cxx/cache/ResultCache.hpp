@@ -0,0 +1,124 @@
+/**
+ * @file ResultCache.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Bounded cache of the results of pure operations, indexed by their content key.
+ */
+
+#ifndef CACHE_RESULTCACHE_HPP_
+#define CACHE_RESULTCACHE_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace proactor {
+namespace cache {
+
+/**
+ * This class keeps the results of a bounded number of operations. When it is full, the entry to
+ * evict is chosen with the CLOCK algorithm (an approximation of LRU): a hand goes over the entries,
+ * giving a second chance to the ones which have been read since its last pass. Unlike LRU, a hit
+ * only sets a flag, so no list has to be reordered.
+ * It is not thread-safe: it is protected by the lock of its owner.
+ * @see asyncOperationProcessor/AsynchronousOperationProcessor
+ */
+template <typename T>
+class ResultCache {
+private:
+	/**
+	 * Entry of the cache
+	 */
+	struct Entry {
+		std::string key;
+		T value;
+		/**
+		 * Read since the last pass of the hand
+		 */
+		bool referenced;
+	};
+
+	/**
+	 * Maximum number of entries
+	 */
+	const size_t capacity;
+	/**
+	 * Entries (the clock)
+	 */
+	std::vector<Entry> entries;
+	/**
+	 * Position of the entries indexed by their key
+	 */
+	std::unordered_map<std::string, size_t> index;
+	/**
+	 * Position of the hand of the clock
+	 */
+	size_t hand;
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] capacity	Maximum number of entries
+	 */
+	ResultCache(const size_t capacity) : capacity(capacity), hand(0) {
+		entries.reserve(capacity);
+		index.reserve(capacity);
+	};
+
+	/**
+	 * Look up a result
+	 * @param[in] key		Content key of the operation
+	 * @param[out] value	Result of the operation, if it is cached
+	 * @return				True if the result is cached
+	 */
+	bool get(const std::string& key, T& value) {
+		typename std::unordered_map<std::string, size_t>::const_iterator iter = index.find(key);
+		if (iter == index.end())
+			return false;
+		Entry& entry = entries[iter->second];
+		entry.referenced = true;
+		value = entry.value;
+		return true;
+	};
+
+	/**
+	 * Store a result, evicting another one if the cache is full
+	 * @param[in] key	Content key of the operation
+	 * @param[in] value	Result of the operation
+	 */
+	void put(const std::string& key, const T& value) {
+		if (capacity == 0)
+			return;
+		typename std::unordered_map<std::string, size_t>::const_iterator iter = index.find(key);
+		if (iter != index.end()) {
+			entries[iter->second].value = value;
+			return;
+		}
+		if (entries.size() < capacity) {
+			index[key] = entries.size();
+			entries.push_back(Entry{key, value, false});
+			return;
+		}
+		// Advance the hand until an entry which has not been read since the last pass
+		while (entries[hand].referenced) {
+			entries[hand].referenced = false;
+			hand = (hand + 1) % capacity;
+		}
+		index.erase(entries[hand].key);
+		index[key] = hand;
+		entries[hand] = Entry{key, value, false};
+		hand = (hand + 1) % capacity;
+	};
+
+	/**
+	 * Obtain the number of cached results
+	 */
+	size_t size() const {
+		return entries.size();
+	};
+};
+
+} /* namespace cache */
+} /* namespace proactor */
+
+#endif /* CACHE_RESULTCACHE_HPP_ */
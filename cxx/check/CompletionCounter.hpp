@@ -0,0 +1,64 @@
+/**
+ * @file CompletionCounter.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Completion handler used by the programs which check the engine.
+ */
+
+#ifndef CHECK_COMPLETIONCOUNTER_HPP_
+#define CHECK_COMPLETIONCOUNTER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../observer/Observer.hpp"
+
+namespace proactor {
+namespace check {
+
+/**
+ * This class is a completion handler which counts the completions. It may be invoked concurrently
+ * (inline completions), and it can be slowed down so that the completions pile up in the engine.
+ */
+class CompletionCounter : public observer::Observer<asyncOperation::AsynchronousOperation<long> > {
+private:
+	/**
+	 * Time each completion takes (in nanoseconds)
+	 */
+	std::atomic<int64_t> handlingTime;
+
+public:
+	/**
+	 * Number of completed operations
+	 */
+	std::atomic<size_t> completed;
+
+	/**
+	 * Class constructor
+	 */
+	CompletionCounter() : handlingTime(0), completed(0) {
+	};
+
+	/**
+	 * Set the time each completion takes
+	 * @param[in] handlingTime	Time (zero to count the completions as fast as possible)
+	 */
+	void setHandlingTime(const std::chrono::nanoseconds& handlingTime) {
+		this->handlingTime.store(handlingTime.count(), std::memory_order_relaxed);
+	};
+
+	void notify(asyncOperation::AsynchronousOperation<long>*) {
+		const int64_t delay = handlingTime.load(std::memory_order_relaxed);
+		if (delay > 0)
+			std::this_thread::sleep_for(std::chrono::nanoseconds(delay));
+		completed.fetch_add(1, std::memory_order_relaxed);
+	};
+};
+
+} /* namespace check */
+} /* namespace proactor */
+
+#endif /* CHECK_COMPLETIONCOUNTER_HPP_ */
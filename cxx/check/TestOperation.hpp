@@ -0,0 +1,55 @@
+/**
+ * @file TestOperation.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Operation used by the programs which check the engine.
+ */
+
+#ifndef CHECK_TESTOPERATION_HPP_
+#define CHECK_TESTOPERATION_HPP_
+
+#include <chrono>
+#include <thread>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+
+namespace proactor {
+namespace check {
+
+/**
+ * This class is an operation which only takes a fixed time (sleeping, as a blocking call would do)
+ * and whose result is 1. Without a service time it does nothing, so that only the engine is measured.
+ */
+class TestOperation : public asyncOperation::AsynchronousOperation<long> {
+private:
+	/**
+	 * Time the operation takes
+	 */
+	std::chrono::nanoseconds serviceTime;
+
+protected:
+	void executeOperation() {
+		if (serviceTime > std::chrono::nanoseconds::zero())
+			std::this_thread::sleep_for(serviceTime);
+		this->result = 1;
+		this->executed = true;
+	};
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] serviceTime	Time the operation takes
+	 */
+	explicit TestOperation(const std::chrono::nanoseconds& serviceTime = std::chrono::nanoseconds::zero()) :
+		serviceTime(serviceTime) {
+	};
+
+	long getResult() const {
+		return this->result;
+	};
+};
+
+} /* namespace check */
+} /* namespace proactor */
+
+#endif /* CHECK_TESTOPERATION_HPP_ */
@@ -3,6 +3,9 @@
  * @author Ronald T. Fernandez
  * @version 1.0
  * This is the main class, which executes a set of asynchronous operations.
+ * Usage: Client [traceFile]
+ * If the tracing support is compiled in, the lifecycle of the operations is written in traceFile
+ * (Chrome trace-event format).
  * @see asyncOperation/AsynchronousOperation
  * @see asyncOperation/SumAsynchronousOperation
  * @see asyncOperationProcessor/InitiatorCompletion
@@ -10,7 +13,9 @@
  * @see proactor/Proactor
  */
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 
 #include "../asyncOperation/AsynchronousOperation.hpp"
@@ -19,11 +24,20 @@
 #include "../initiatorCompletion/InitiatorCompletion.hpp"
 #include "../logger/Logger.hpp"
 #include "../proactor/Proactor.hpp"
+#include "../trace/TraceRecorder.hpp"
 
 using namespace proactor::asyncOperation;
 
 int main(int argc, char *argv[]) {
 
+	// Record the lifecycle of the operations, if requested
+	if (argc > 1) {
+		if (proactor::trace::TRACE_COMPILED)
+			proactor::trace::TraceRecorder::enable();
+		else
+			proactor::logger::Logger::log("Tracing is not compiled in (build with TRACE=1).");
+	}
+
 	// Create operations
 	SumAsynchronousOperation<int> op1 = SumAsynchronousOperation<int>(10, 11);
 	SumAsynchronousOperation<int> op2 = SumAsynchronousOperation<int>(20, 21);
@@ -39,11 +53,19 @@ int main(int argc, char *argv[]) {
 	initiator.processOperation(&op1);
 	initiator.processOperation(&op2);
 	initiator.processOperation(&op3);
-	initiator.processOperation(&op4);
-	initiator.processOperation(&op5);
-	initiator.processOperation(&op6);
+	// The last operations are submitted as a batch
+	AsynchronousOperation<int>* batch[] = {&op4, &op5, &op6};
+	initiator.processOperations(std::begin(batch), std::end(batch));
 
 	proactor::logger::Logger::log("Done.");
 
+	// Export the trace once all the operations have been dispatched
+	if (proactor::trace::TraceRecorder::isEnabled()) {
+		initiator.shutdown(proactor::initiatorCompletion::ShutdownMode::GRACEFUL);
+		std::ofstream traceFile(argv[1]);
+		proactor::trace::TraceRecorder::writeChromeTrace(traceFile);
+		proactor::logger::Logger::log("Trace written in " + std::string(argv[1]));
+	}
+
 	return 0;
 }
@@ -9,37 +9,57 @@
 #ifndef COMPLETIONEVENTQUEUE_COMPLETIONEVENTQUEUE_HPP_
 #define COMPLETIONEVENTQUEUE_COMPLETIONEVENTQUEUE_HPP_
 
-#include <deque>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <utility>
 
 #include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../policy/Policies.hpp"
+#include "../utils/RingBuffer.hpp"
 
 namespace proactor {
 namespace completionEventQueue {
 
 /**
  * This class defines the queue of completed events.
+ * @tparam Policies	Configuration of the engine (its Locking policy synchronizes the queue)
  */
-template <typename T>
-class CompletionEventQueue : private  std::deque<asyncOperation::AsynchronousOperation<T>*> {
+template <typename T, typename Policies = policy::DefaultPolicies>
+class CompletionEventQueue : private  utils::RingBuffer<asyncOperation::AsynchronousOperation<T>*> {
 private:
+	typedef typename Policies::Locking::Mutex Mutex;
 	/**
 	 * Lock to push and pop events in the queue
 	 */
-	std::mutex mutex;
+	Mutex mutex;
 	/**
 	 * Operations which are being processed and which are not terminated. This counter is
 	 * useful because, in case the system needs to be shut down, all the pending operations
 	 * are correctly calculated and finished before the full system terminates
 	 */
 	unsigned int pendingOperations;
+	/**
+	 * Condition variable used to wake up the consumer when a completion event is pushed, when
+	 * an operation terminates or when the queue is closed
+	 */
+	typename Policies::Locking::ConditionVariable cv;
+	/**
+	 * Indicates that the consumer has to finish once all the pending operations have been
+	 * terminated and their completion events retrieved
+	 */
+	bool closed;
+	/**
+	 * Function invoked (with the lock held) when the consumer has to be woken up, if it does not
+	 * wait in the queue (e.g. it runs in a shared executor)
+	 */
+	std::function<void()> wakeup;
 public:
 	/**
 	 * Class constructor
 	 */
-	CompletionEventQueue() : std::deque<asyncOperation::AsynchronousOperation<T>*>(), pendingOperations(0) {
+	CompletionEventQueue() : utils::RingBuffer<asyncOperation::AsynchronousOperation<T>*>(), pendingOperations(0), closed(false) {
 	};
 
 	/**
@@ -55,7 +75,7 @@ public:
 	 */
 	asyncOperation::AsynchronousOperation<T>* pop() {
 		// Lock the queue
-		std::lock_guard<std::mutex> locker(mutex);
+		std::lock_guard<Mutex> locker(mutex);
 
 		// Get the first element
 		asyncOperation::AsynchronousOperation<T>* p = this->front();
@@ -68,19 +88,86 @@ public:
 	}
 
 	/**
-	 * Add an operation to the completion queue
+	 * Wait until there is a completion event in the queue and retrieve it. The method does not
+	 * poll: it is woken up when an event is pushed or when the queue is closed.
+	 * @param[out] operation	Operation retrieved from the completion queue
+	 * @return					True if an operation has been retrieved, or false if the queue has been
+	 * 							closed and there are neither events nor pending operations
 	 */
-	void push(asyncOperation::AsynchronousOperation<T> *operation) {
+	bool waitAndPop(asyncOperation::AsynchronousOperation<T>*& operation) {
 		// Lock the queue
-		std::lock_guard<std::mutex> locker(mutex);
-		// Insert the element into the queue
-		this->push_back(operation);
+		std::unique_lock<Mutex> locker(mutex);
+		cv.wait(locker, [&]{ return !this->empty() || (closed && (pendingOperations == 0));});
+		if (this->empty())
+			return false;
+
+		operation = this->front();
+		this->pop_front();
+		return true;
+	}
+
+	/**
+	 * Retrieve a completion event, if there is any, without waiting
+	 * @param[out] operation	Operation retrieved from the completion queue
+	 * @param[out] finished		Set if the queue has been closed and there are neither events (after
+	 * 							retrieving this one) nor pending operations
+	 * @return					True if an operation has been retrieved
+	 */
+	bool tryPop(asyncOperation::AsynchronousOperation<T>*& operation, bool& finished) {
+		std::lock_guard<Mutex> locker(mutex);
+		const bool retrieved = !this->empty();
+		if (retrieved) {
+			operation = this->front();
+			this->pop_front();
+		}
+		finished = this->empty() && closed && (pendingOperations == 0);
+		return retrieved;
+	}
 
-		// Update the counter of pending operations
-		if (pendingOperations == 0)
-			throw std::exception();
-		--pendingOperations;
+	/**
+	 * Set the function which wakes up the consumer, instead of the condition variable. It is invoked
+	 * with the lock held, once per pushed event and whenever the queue may have finished, so a
+	 * consumer which calls tryPop once per invocation does not miss any event
+	 * @param[in] wakeup	Function which wakes up the consumer
+	 */
+	void setWakeup(const std::function<void()>& wakeup) {
+		std::lock_guard<Mutex> locker(mutex);
+		this->wakeup = wakeup;
+	}
+
+	/**
+	 * Close the queue: the consumer finishes as soon as all the pending operations have been
+	 * terminated and their completion events retrieved. Completion events can still be pushed.
+	 */
+	void close() {
+		{
+			std::lock_guard<Mutex> locker(mutex);
+			closed = true;
+			if (wakeup)
+				wakeup();
+		}
+		cv.notify_all();
+	}
 
+	/**
+	 * Add an operation to the completion queue
+	 */
+	void push(asyncOperation::AsynchronousOperation<T> *operation) {
+		{
+			// Lock the queue
+			std::lock_guard<Mutex> locker(mutex);
+			// Insert the element into the queue
+			this->push_back(operation);
+
+			// Update the counter of pending operations
+			if (pendingOperations == 0)
+				throw std::exception();
+			--pendingOperations;
+			if (wakeup)
+				wakeup();
+		}
+		// Wake up the consumer
+		cv.notify_one();
 	};
 
 	/**
@@ -89,18 +176,38 @@ public:
 	 */
 	const size_t size() {
 		// Lock the queue
-		std::lock_guard<std::mutex> locker(mutex);
+		std::lock_guard<Mutex> locker(mutex);
 		// Return the size of the queue
-		return std::deque<asyncOperation::AsynchronousOperation<T>*>::size();
+		return utils::RingBuffer<asyncOperation::AsynchronousOperation<T>*>::size();
 	}
 
 	/**
 	 * Increment the number of operations which are being processed but
 	 * not terminated
+	 * @param[in] count	Number of new operations (1 if it is not defined)
+	 */
+	void incrementPendingOperations(const unsigned int count = 1) {
+		std::lock_guard<Mutex> locker(mutex);
+		pendingOperations += count;
+	}
+
+	/**
+	 * Decrement the number of operations which are being processed but not terminated.
+	 * This is used for the operations whose completion is handled without the queue, or which
+	 * have been discarded before being executed.
+	 * @param[in] count	Number of terminated operations (1 if it is not defined)
 	 */
-	void incrementPendingOperations() {
-		std::lock_guard<std::mutex> locker(mutex);
-		++pendingOperations;
+	void decrementPendingOperations(const unsigned int count = 1) {
+		{
+			std::lock_guard<Mutex> locker(mutex);
+			if (pendingOperations < count)
+				throw std::exception();
+			pendingOperations -= count;
+			if (wakeup && closed && (pendingOperations == 0))
+				wakeup();
+		}
+		// The consumer might be waiting for the last pending operation
+		cv.notify_one();
 	}
 
 	/**
@@ -108,8 +215,8 @@ public:
 	 */
 	bool arePendingOperations() {
 		// We use the lock here to ensure that the counter is not modified
-		std::lock_guard<std::mutex> locker(mutex);
-		return (pendingOperations == 0);
+		std::lock_guard<Mutex> locker(mutex);
+		return (pendingOperations != 0);
 	}
 };
 
@@ -0,0 +1,134 @@
+/**
+ * @file CompletionLatency.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Latency of the completions: time from the end of an operation in a worker to the invocation of its
+ * completion handler, with the completions serialized (completion event queue and proactor thread)
+ * and inline (in the worker). The operations are submitted one at a time, spaced out so that each
+ * completion is measured on an idle engine.
+ * Usage: CompletionLatency [OPERATIONS] [INTERVAL_US]
+ *   (default: 2000 operations per mode, submitted every 500 microseconds)
+ * @see asyncOperation/AsynchronousOperation (CompletionMode)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../logger/Logger.hpp"
+#include "../observer/Observer.hpp"
+
+using namespace proactor;
+
+/**
+ * Operation which does nothing but record when it has finished
+ */
+class TimedOperation : public asyncOperation::AsynchronousOperation<long> {
+public:
+	/**
+	 * Position of the operation in the test
+	 */
+	size_t index;
+	/**
+	 * Time at which the operation finished in the worker
+	 */
+	std::chrono::steady_clock::time_point finished;
+
+	/**
+	 * Class constructor
+	 */
+	TimedOperation() : index(0) {
+	};
+
+protected:
+	void executeOperation() {
+		this->result = 1;
+		this->executed = true;
+		finished = std::chrono::steady_clock::now();
+	};
+
+public:
+	long getResult() const {
+		return this->result;
+	};
+};
+
+/**
+ * Handler which records the latency of each completion. Each operation has its own entry, so the
+ * inline completions can be recorded concurrently without a lock
+ */
+class LatencyRecorder : public observer::Observer<asyncOperation::AsynchronousOperation<long> > {
+public:
+	/**
+	 * Latency of each operation (in microseconds)
+	 */
+	std::vector<double> latencies;
+
+	/**
+	 * Class constructor
+	 * @param[in] operations	Number of operations
+	 */
+	explicit LatencyRecorder(const size_t operations) : latencies(operations, 0) {
+	};
+
+	void notify(asyncOperation::AsynchronousOperation<long>* operation) {
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		const TimedOperation* timed = static_cast<TimedOperation*>(operation);
+		latencies[timed->index] = std::chrono::duration<double, std::micro>(now - timed->finished).count();
+	};
+};
+
+/**
+ * Measure the latency of the completions in a completion mode and display its percentiles
+ * @param[in] name			Name of the mode
+ * @param[in] mode			Completion mode of the engine
+ * @param[in] operations	Number of operations
+ * @param[in] interval		Time between two submissions
+ */
+void measure(const std::string& name, const asyncOperation::CompletionMode mode, const size_t operations,
+			 const std::chrono::microseconds& interval) {
+	std::vector<TimedOperation> timed(operations);
+	LatencyRecorder recorder(operations);
+	{
+		initiatorCompletion::InitiatorCompletion<long> initiator(&recorder, mode);
+		for (size_t i = 0; i < operations; ++i) {
+			timed[i].index = i;
+			initiator.processOperation(&timed[i]);
+			std::this_thread::sleep_for(interval);
+		}
+		// The destructor waits for the last completions
+	}
+
+	std::vector<double>& latencies = recorder.latencies;
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(1);
+	const double percentiles[] = {0.5, 0.9, 0.99, 1.0};
+	for (double percentile : percentiles) {
+		const size_t rank = static_cast<size_t>(std::ceil(percentile * latencies.size()));
+		std::cout << std::setw(10) << latencies[std::max<size_t>(rank, 1) - 1];
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	const size_t operations = (argc > 1) ? std::stoul(argv[1]) : 2000;
+	const std::chrono::microseconds interval((argc > 2) ? std::stoul(argv[2]) : 500);
+	if (operations == 0) {
+		std::cerr << "Usage: " << argv[0] << " [OPERATIONS] [INTERVAL_US]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	logger::Logger::setEnabled(false);
+
+	std::cout << "Latency (us)       p50       p90       p99       max" << std::endl;
+	measure("serialized", asyncOperation::CompletionMode::SERIALIZED, operations, interval);
+	measure("inline", asyncOperation::CompletionMode::INLINE, operations, interval);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file AimdConcurrencyController.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Concurrency controller based on additive increase / multiplicative decrease (AIMD).
+ */
+
+#ifndef CONCURRENCYCONTROLLER_AIMDCONCURRENCYCONTROLLER_HPP_
+#define CONCURRENCYCONTROLLER_AIMDCONCURRENCYCONTROLLER_HPP_
+
+#include <algorithm>
+
+#include "ConcurrencyController.hpp"
+
+namespace proactor {
+namespace concurrencyController {
+
+/**
+ * This class adapts the concurrency limit with the AIMD algorithm, using the execution time of the
+ * operations as the congestion signal:
+ * - It keeps a baseline of the execution time of an operation without contention.
+ * - If an operation takes longer than tolerance * baseline, the workers are oversubscribing the
+ *   resources (cores, disk...) and the limit is multiplied by the backoff factor (once per window of
+ *   'limit' completions, so that a burst of slow operations counts as a single signal).
+ * - Otherwise, if the operations have to wait for a slot (i.e. the limit is the bottleneck), the limit
+ *   is increased by one every 'limit' completions.
+ * @see ConcurrencyController
+ */
+class AimdConcurrencyController : public ConcurrencyController {
+private:
+	/**
+	 * Minimum concurrency limit
+	 */
+	const size_t minLimit;
+	/**
+	 * Maximum concurrency limit
+	 */
+	const size_t maxLimit;
+	/**
+	 * Initial concurrency limit
+	 */
+	const size_t initialLimit;
+	/**
+	 * Ratio between the execution time and the baseline from which the system is considered overloaded
+	 */
+	const double tolerance;
+	/**
+	 * Factor applied to the limit when the system is overloaded
+	 */
+	const double backoff;
+	/**
+	 * Estimation of the execution time without contention (in nanoseconds). Zero if it is unknown
+	 */
+	double baseline;
+	/**
+	 * Accumulated additive increase. The limit is increased when it reaches one
+	 */
+	double increase;
+	/**
+	 * Completions since the last decrease of the limit
+	 */
+	size_t completionsSinceDecrease;
+
+	/**
+	 * Weight of a new sample when the baseline is moved towards it
+	 */
+	static constexpr double BASELINE_DRIFT = 0.01;
+	/**
+	 * Ratio between the queueing time and the baseline from which the limit is considered the bottleneck
+	 */
+	static constexpr double QUEUEING_RATIO = 0.1;
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] minLimit		Minimum concurrency limit (at least 1)
+	 * @param[in] maxLimit		Maximum concurrency limit
+	 * @param[in] initialLimit	Initial concurrency limit. If it is not defined, the minimum limit is used
+	 * @param[in] tolerance		Ratio between the execution time and its baseline from which the system is
+	 * 							considered overloaded (2 if it is not defined)
+	 * @param[in] backoff		Factor applied to the limit when the system is overloaded (0.75 if it is
+	 * 							not defined)
+	 */
+	AimdConcurrencyController(const size_t minLimit,
+							  const size_t maxLimit,
+							  const size_t initialLimit = 0,
+							  const double tolerance = 2.0,
+							  const double backoff = 0.75) :
+								  minLimit(std::max<size_t>(minLimit, 1)),
+								  maxLimit(std::max(maxLimit, std::max<size_t>(minLimit, 1))),
+								  initialLimit(std::min(std::max(initialLimit, this->minLimit), this->maxLimit)),
+								  tolerance(tolerance),
+								  backoff(backoff),
+								  baseline(0),
+								  increase(0),
+								  completionsSinceDecrease(0) {
+	};
+
+	/**
+	 * Class destructor
+	 */
+	virtual ~AimdConcurrencyController() {
+	};
+
+	/**
+	 * Obtain the minimum concurrency limit
+	 */
+	size_t getMinLimit() const {
+		return minLimit;
+	};
+
+	/**
+	 * Obtain the maximum concurrency limit
+	 */
+	size_t getMaxLimit() const {
+		return maxLimit;
+	};
+
+	/**
+	 * Obtain the initial concurrency limit
+	 */
+	size_t getInitialLimit() const {
+		return initialLimit;
+	};
+
+	/**
+	 * Compute the new concurrency limit after an operation has been completed
+	 * @see ConcurrencyController::onCompletion
+	 */
+	size_t onCompletion(const size_t currentLimit,
+						const size_t inFlight,
+						const std::chrono::nanoseconds& queueingTime,
+						const std::chrono::nanoseconds& executionTime) {
+		const double execution = static_cast<double>(executionTime.count());
+		++completionsSinceDecrease;
+
+		// Follow the fastest executions immediately
+		if ((baseline == 0) || (execution < baseline))
+			baseline = execution;
+
+		if (execution > tolerance * baseline) {
+			// Still overloaded with the minimum limit: the workload itself has changed, so move the baseline
+			if (currentLimit == minLimit)
+				baseline += (execution - baseline) * BASELINE_DRIFT;
+			// Multiplicative decrease, once per window
+			if (completionsSinceDecrease < currentLimit)
+				return currentLimit;
+			completionsSinceDecrease = 0;
+			increase = 0;
+			const size_t decreased = static_cast<size_t>(currentLimit * backoff);
+			return std::max(minLimit, std::min(decreased, currentLimit - 1));
+		}
+
+		// Let the baseline adapt to slower (but not overloaded) executions
+		baseline += (execution - baseline) * BASELINE_DRIFT;
+
+		// Additive increase, only if the limit is the bottleneck
+		if ((inFlight >= currentLimit) && (queueingTime.count() > QUEUEING_RATIO * baseline)) {
+			increase += 1.0 / currentLimit;
+			if (increase >= 1.0) {
+				increase -= 1.0;
+				return std::min(maxLimit, currentLimit + 1);
+			}
+		}
+		return currentLimit;
+	};
+};
+
+} /* namespace concurrencyController */
+} /* namespace proactor */
+
+#endif /* CONCURRENCYCONTROLLER_AIMDCONCURRENCYCONTROLLER_HPP_ */
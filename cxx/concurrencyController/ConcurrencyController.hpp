@@ -0,0 +1,64 @@
+/**
+ * @file ConcurrencyController.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Interface of the controllers which adapt the number of operations executed concurrently
+ * by the asynchronous operation processor.
+ */
+
+#ifndef CONCURRENCYCONTROLLER_CONCURRENCYCONTROLLER_HPP_
+#define CONCURRENCYCONTROLLER_CONCURRENCYCONTROLLER_HPP_
+
+#include <chrono>
+#include <cstddef>
+
+namespace proactor {
+namespace concurrencyController {
+
+/**
+ * This class defines the interface of a concurrency controller. The processor informs the controller
+ * about each completed operation and the controller returns the new concurrency limit, which must be
+ * in the range [getMinLimit(), getMaxLimit()].
+ * The processor calls the controller with its lock held, so implementations do not need to be thread-safe.
+ * @see asyncOperationProcessor/AsynchronousOperationProcessor
+ */
+class ConcurrencyController {
+public:
+	/**
+	 * Obtain the minimum concurrency limit
+	 */
+	virtual size_t getMinLimit() const = 0;
+
+	/**
+	 * Obtain the maximum concurrency limit. The processor starts as many workers as this value
+	 */
+	virtual size_t getMaxLimit() const = 0;
+
+	/**
+	 * Obtain the concurrency limit to use before any operation has been completed
+	 */
+	virtual size_t getInitialLimit() const = 0;
+
+	/**
+	 * Notify the controller that an operation has been completed
+	 * @param[in] currentLimit		Concurrency limit when the operation was completed
+	 * @param[in] inFlight			Operations in the processor (including the completed one)
+	 * @param[in] queueingTime		Time from the submission of the operation until it was started
+	 * @param[in] executionTime		Time spent executing the operation
+	 * @return						New concurrency limit
+	 */
+	virtual size_t onCompletion(const size_t currentLimit,
+								const size_t inFlight,
+								const std::chrono::nanoseconds& queueingTime,
+								const std::chrono::nanoseconds& executionTime) = 0;
+
+	/**
+	 * Class destructor
+	 */
+	virtual ~ConcurrencyController() {};
+};
+
+} /* namespace concurrencyController */
+} /* namespace proactor */
+
+#endif /* CONCURRENCYCONTROLLER_CONCURRENCYCONTROLLER_HPP_ */
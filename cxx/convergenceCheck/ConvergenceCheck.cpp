@@ -0,0 +1,221 @@
+/**
+ * @file ConvergenceCheck.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Check that the AIMD concurrency controller converges to the optimal concurrency of a synthetic
+ * workload. The operations use a simulated server with a fixed number of cores: with up to that
+ * number of operations in flight, each one takes the service time; beyond it, the extra operations
+ * wait for a core, so the execution time grows without any gain in throughput. The optimal limit is
+ * therefore the number of cores. The workload is changed in the middle of the run (fewer cores) and
+ * the limit has to follow it. The program fails if, in the second half of any phase, the average
+ * limit is not within a factor 2 of the number of cores.
+ * Usage: ConvergenceCheck [PHASE_SECONDS]
+ *   (default: 3 seconds per phase)
+ * @see concurrencyController/AimdConcurrencyController
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../concurrencyController/AimdConcurrencyController.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../logger/Logger.hpp"
+#include "../observer/Observer.hpp"
+
+using namespace proactor;
+
+/**
+ * Time an operation needs a core
+ */
+const std::chrono::milliseconds SERVICE_TIME(2);
+/**
+ * Limits of the controller
+ */
+const size_t MIN_LIMIT = 1;
+const size_t MAX_LIMIT = 32;
+/**
+ * Interval between two samples of the limit
+ */
+const std::chrono::milliseconds SAMPLE_INTERVAL(50);
+
+/**
+ * Server with a number of cores: an operation holds a core while it is served, and waits if all of
+ * them are busy
+ */
+class SimulatedServer {
+private:
+	/**
+	 * Lock of the cores
+	 */
+	std::mutex mutex;
+	/**
+	 * Condition variable used to wait for a free core
+	 */
+	std::condition_variable cv;
+	/**
+	 * Number of cores
+	 */
+	size_t cores;
+	/**
+	 * Busy cores
+	 */
+	size_t busy;
+
+public:
+	/**
+	 * Class constructor
+	 */
+	SimulatedServer() : cores(1), busy(0) {
+	};
+
+	/**
+	 * Change the number of cores
+	 * @param[in] cores	Number of cores
+	 */
+	void setCores(const size_t cores) {
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			this->cores = cores;
+		}
+		cv.notify_all();
+	};
+
+	/**
+	 * Serve a request: wait for a core and hold it for the service time
+	 */
+	void serve() {
+		{
+			std::unique_lock<std::mutex> locker(mutex);
+			cv.wait(locker, [&]{ return busy < cores;});
+			++busy;
+		}
+		std::this_thread::sleep_for(SERVICE_TIME);
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			--busy;
+		}
+		cv.notify_one();
+	};
+};
+
+/**
+ * Operation served by the simulated server
+ */
+class ServerOperation : public asyncOperation::AsynchronousOperation<long> {
+private:
+	/**
+	 * Server which serves the operation
+	 */
+	SimulatedServer* server;
+
+protected:
+	void executeOperation() {
+		server->serve();
+		this->result = 1;
+		this->executed = true;
+	};
+
+public:
+	/**
+	 * Indicates whether the completion has been dispatched (the operation can then be submitted again)
+	 */
+	std::atomic<bool> completed;
+
+	/**
+	 * Class constructor
+	 */
+	ServerOperation() : server(NULL), completed(true) {
+	};
+
+	/**
+	 * Prepare the operation to be submitted
+	 * @param[in] server	Server of the operation
+	 */
+	void reset(SimulatedServer* server) {
+		this->server = server;
+		this->executed = false;
+		completed.store(false);
+	};
+
+	long getResult() const {
+		return this->result;
+	};
+};
+
+/**
+ * Handler which marks the operations as completed
+ */
+class CompletionMarker : public observer::Observer<asyncOperation::AsynchronousOperation<long> > {
+public:
+	void notify(asyncOperation::AsynchronousOperation<long>* operation) {
+		static_cast<ServerOperation*>(operation)->completed.store(true);
+	};
+};
+
+int main(int argc, char *argv[]) {
+	const std::chrono::milliseconds phaseTime((argc > 1) ? std::stoul(argv[1]) * 1000 : 3000);
+	logger::Logger::setEnabled(false);
+	const size_t phases[] = {8, 3};
+
+	SimulatedServer server;
+	CompletionMarker marker;
+	// With a tolerance of 1.5, the limit is decreased once the operations wait half their service time
+	std::shared_ptr<concurrencyController::AimdConcurrencyController> controller =
+			std::make_shared<concurrencyController::AimdConcurrencyController>(MIN_LIMIT, MAX_LIMIT, MIN_LIMIT, 1.5);
+	initiatorCompletion::InitiatorCompletion<long> initiator(&marker, asyncOperation::CompletionMode::SERIALIZED,
+			MAX_LIMIT, controller);
+
+	// The submitter keeps the processor saturated (each submission waits for a free slot), reusing
+	// the operations once they have been completed
+	std::vector<ServerOperation> operations(MAX_LIMIT * 4);
+	std::atomic<bool> stop(false);
+	std::thread submitter([&]() {
+		for (size_t i = 0; !stop.load(); i = (i + 1) % operations.size()) {
+			while (!operations[i].completed.load())
+				std::this_thread::yield();
+			operations[i].reset(&server);
+			initiator.processOperation(&operations[i]);
+		}
+	});
+
+	bool passed = true;
+	for (size_t cores : phases) {
+		server.setCores(cores);
+		std::vector<size_t> samples;
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + phaseTime;
+		while (std::chrono::steady_clock::now() < end) {
+			std::this_thread::sleep_for(SAMPLE_INTERVAL);
+			samples.push_back(initiator.getConcurrencyLimit());
+		}
+
+		// The first half of the phase is the transient
+		double average = 0;
+		for (size_t i = samples.size() / 2; i < samples.size(); ++i)
+			average += samples[i];
+		average /= samples.size() - samples.size() / 2;
+		const bool converged = (average >= cores / 2.0) && (average <= cores * 2.0);
+		passed &= converged;
+
+		std::cout << "Cores " << std::setw(2) << cores << ": limit";
+		for (size_t i = 0; i < samples.size(); i += 5)
+			std::cout << ' ' << samples[i];
+		std::cout << std::fixed << std::setprecision(1) << " -> average " << average << " (expected "
+				  << cores / 2.0 << "-" << cores * 2.0 << ")" << (converged ? "" : "  FAILED") << std::endl;
+	}
+
+	stop.store(true);
+	submitter.join();
+	initiator.shutdown(initiatorCompletion::ShutdownMode::GRACEFUL);
+	std::cout << (passed ? "PASSED" : "FAILED: the limit does not converge to the optimal concurrency") << std::endl;
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
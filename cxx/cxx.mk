@@ -1,14 +1,21 @@
-.PHONY: clean all run
+.PHONY: clean all run check
 CC = g++
-CCFLAGS = -Wall -std=c++11
+CCFLAGS = -Wall -O2 -std=c++11
+LDFLAGS = -pthread
+# Build with "make TRACE=1" to compile in the operation tracing support
+ifeq ($(TRACE),1)
+CCFLAGS += -DPROACTOR_TRACE
+endif
 TARGET = client/Client
 SRCEXT := cpp
 SOURCES = $(shell find . -type f -name *.$(SRCEXT))
 OBJECTS = $(SOURCES:.cpp=.o)
+# Each source file is a program (the library is header-only)
+TARGETS = $(SOURCES:.cpp=)
 
-# Main target
-$(TARGET): $(OBJECTS)
-	$(CC) $(OBJECTS) -o $(TARGET)
+# Programs
+$(TARGETS): %: %.o
+	$(CC) $< -o $@ $(LDFLAGS)
  
 # To obtain object files
 %.o: %.cpp
@@ -16,11 +23,17 @@ $(TARGET): $(OBJECTS)
  
 # To remove generated files
 clean:
-	rm -f $(TARGET) $(OBJECTS)
-all: clean $(TARGET)
+	rm -f $(TARGETS) $(OBJECTS)
+all: clean $(TARGETS)
 
 run:	all
 	./$(TARGET)
 
+# Programs which verify the engine (each one fails if its check does not hold)
+CHECKS = allocationCheck/AllocationCheck shutdownCheck/ShutdownCheck convergenceCheck/ConvergenceCheck \
+	fileReductionDemo/FileReductionDemo
+check:	$(CHECKS)
+	@for program in $(CHECKS); do echo "./$$program"; ./$$program || exit 1; done
+
 doxygen:
 	doxygen .doxygen.conf
@@ -0,0 +1,53 @@
+/**
+ * @file IOException.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Exception launched when an operation cannot access a file
+ */
+
+#include <exception>
+#include <iostream>
+
+#ifndef IOEXCEPTION_HPP_
+#define IOEXCEPTION_HPP_
+
+#include "../logger/Logger.hpp"
+
+namespace proactor {
+namespace exception {
+
+/**
+ * This class represents an exception which has been thrown because a file
+ * could not be opened, read or mapped
+ */
+class IOException : public std::exception {
+private:
+	std::string message;
+public:
+	/**
+	 * Class constructor
+	 */
+	IOException() : std::exception(), message("") {
+	};
+
+	/**
+	 * Class constructor
+	 * @param[in] message	Message which describes the exception. The message is shown
+	 * 						in the log.
+	 */
+	IOException(std::string message) : std::exception(), message(message) {
+		logger::Logger::log(message);
+	}
+
+	/**
+	 * Obtain the description of the exception (the reason why the exception
+	 * has been thrown)
+	 */
+	const std::string getMessage() const {
+		return this->message;
+	}
+};
+}
+}
+
+#endif /* IOEXCEPTION_HPP_ */
@@ -0,0 +1,54 @@
+/**
+ * @file ShutdownException.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Exception launched when an operation is submitted to a system which
+ * is being shut down
+ */
+
+#include <exception>
+#include <iostream>
+
+#ifndef SHUTDOWNEXCEPTION_HPP_
+#define SHUTDOWNEXCEPTION_HPP_
+
+#include "../logger/Logger.hpp"
+
+namespace proactor {
+namespace exception {
+
+/**
+ * This class represents an exception which has been thrown because an
+ * operation has been submitted after the system has been requested to shut down
+ */
+class ShutdownException : public std::exception {
+private:
+	std::string message;
+public:
+	/**
+	 * Class constructor
+	 */
+	ShutdownException() : std::exception(), message("") {
+	};
+
+	/**
+	 * Class constructor
+	 * @param[in] message	Message which describes the exception. The message is shown
+	 * 						in the log.
+	 */
+	ShutdownException(std::string message) : std::exception(), message(message) {
+		logger::Logger::log(message);
+	}
+
+	/**
+	 * Obtain the description of the exception (the reason why the exception
+	 * has been thrown)
+	 */
+	const std::string getMessage() const {
+		return this->message;
+	}
+};
+}
+}
+
+#endif /* SHUTDOWNEXCEPTION_HPP_ */
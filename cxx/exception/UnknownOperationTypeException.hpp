@@ -0,0 +1,54 @@
+/**
+ * @file UnknownOperationTypeException.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Exception launched when an operation has to be created from a type
+ * which has not been registered
+ */
+
+#include <exception>
+#include <iostream>
+
+#ifndef UNKNOWNOPERATIONTYPEEXCEPTION_HPP_
+#define UNKNOWNOPERATIONTYPEEXCEPTION_HPP_
+
+#include "../logger/Logger.hpp"
+
+namespace proactor {
+namespace exception {
+
+/**
+ * This class represents an exception which has been thrown because an
+ * operation could not be created: its type is not registered
+ */
+class UnknownOperationTypeException : public std::exception {
+private:
+	std::string message;
+public:
+	/**
+	 * Class constructor
+	 */
+	UnknownOperationTypeException() : std::exception(), message("") {
+	};
+
+	/**
+	 * Class constructor
+	 * @param[in] message	Message which describes the exception. The message is shown
+	 * 						in the log.
+	 */
+	UnknownOperationTypeException(std::string message) : std::exception(), message(message) {
+		logger::Logger::log(message);
+	}
+
+	/**
+	 * Obtain the description of the exception (the reason why the exception
+	 * has been thrown)
+	 */
+	const std::string getMessage() const {
+		return this->message;
+	}
+};
+}
+}
+
+#endif /* UNKNOWNOPERATIONTYPEEXCEPTION_HPP_ */
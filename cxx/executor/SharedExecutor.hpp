@@ -0,0 +1,284 @@
+/**
+ * @file SharedExecutor.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Pool of threads shared by several engines, with a fair share of the threads for each one.
+ */
+
+#ifndef EXECUTOR_SHAREDEXECUTOR_HPP_
+#define EXECUTOR_SHAREDEXECUTOR_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../trace/TraceRecorder.hpp"
+#include "../utils/RingBuffer.hpp"
+#include "../watchdog/Watchdog.hpp"
+#include "TaskSource.hpp"
+
+namespace proactor {
+namespace executor {
+
+/**
+ * This class is a pool of threads which runs the tasks of several sources (the processors and the
+ * proactors of several InitiatorCompletion instances), so that the whole process runs on a single pool
+ * sized for the machine instead of a pool and a proactor thread per engine.
+ * The sources with ready tasks take turns (weighted round robin): in each turn, a source runs as many
+ * tasks as its weight, so a busy source cannot starve the others and the threads are shared in
+ * proportion to the weights. A source can also limit the number of its tasks run concurrently (the
+ * proactor uses 1, so that its completions are still dispatched one after another).
+ * @see initiatorCompletion::InitiatorCompletion
+ */
+class SharedExecutor {
+public:
+	/**
+	 * Registration of a source in the executor
+	 */
+	class Client {
+	private:
+		friend class SharedExecutor;
+
+		/**
+		 * Source of the tasks
+		 */
+		TaskSource* source;
+		/**
+		 * Activity of the tasks, for the watchdog
+		 */
+		watchdog::StallKind kind;
+		/**
+		 * Tasks run per turn
+		 */
+		unsigned int weight;
+		/**
+		 * Maximum number of tasks run concurrently
+		 */
+		size_t maxConcurrency;
+		/**
+		 * Ready tasks
+		 */
+		size_t ready;
+		/**
+		 * Tasks being run
+		 */
+		size_t running;
+		/**
+		 * Tasks left in the current turn
+		 */
+		unsigned int credit;
+		/**
+		 * Indicates whether the client is waiting for its turn
+		 */
+		bool scheduled;
+		/**
+		 * Tasks run
+		 */
+		uint64_t executed;
+
+	public:
+		Client(TaskSource* source, const watchdog::StallKind kind, const unsigned int weight, const size_t maxConcurrency) :
+			source(source), kind(kind), weight(std::max(weight, 1u)), maxConcurrency(std::max<size_t>(maxConcurrency, 1)),
+			ready(0), running(0), credit(this->weight), scheduled(false), executed(0) {
+		};
+	};
+
+private:
+	/**
+	 * Lock of the clients and the schedule
+	 */
+	std::mutex mutex;
+	/**
+	 * Condition variable used to wake up the threads when there are ready tasks
+	 */
+	std::condition_variable workCv;
+	/**
+	 * Condition variable used to wait until the tasks of a client have finished
+	 */
+	std::condition_variable idleCv;
+	/**
+	 * Registered clients (a list, so that their addresses do not change)
+	 */
+	std::list<Client> clients;
+	/**
+	 * Clients with ready tasks, in the order of their turns
+	 */
+	utils::RingBuffer<Client*> schedule;
+	/**
+	 * Watchdog of the threads (optional)
+	 */
+	std::shared_ptr<watchdog::Watchdog> stallWatchdog;
+	/**
+	 * Threads of the pool
+	 */
+	std::vector<std::thread> threads;
+	/**
+	 * Indicates that the threads have to finish
+	 */
+	bool stop;
+
+	/**
+	 * Put a client in the schedule if it has tasks which can be run. It must be called with the lock held
+	 * @param[in] client	Client
+	 */
+	void reschedule(Client* client) {
+		if (!client->scheduled && (client->ready > 0) && (client->running < client->maxConcurrency)) {
+			client->scheduled = true;
+			schedule.push_back(client);
+			workCv.notify_one();
+		}
+	};
+
+	/**
+	 * Main loop of the threads: they run the task of the client whose turn it is
+	 */
+	void work() {
+		trace::traceThreadName("executor");
+		watchdog::ActivitySlot* slots[2] = {NULL, NULL};
+		if (stallWatchdog) {
+			slots[static_cast<int>(watchdog::StallKind::OPERATION)] = stallWatchdog->registerThread(watchdog::StallKind::OPERATION, "executor");
+			slots[static_cast<int>(watchdog::StallKind::DISPATCH)] = stallWatchdog->registerThread(watchdog::StallKind::DISPATCH, "executor");
+		}
+		std::unique_lock<std::mutex> locker(mutex);
+		while (true) {
+			workCv.wait(locker, [&]{ return stop || !schedule.empty();});
+			if (schedule.empty())
+				break;
+			Client* client = schedule.front();
+			--client->ready;
+			++client->running;
+			// The turn finishes when the client has used its credit or cannot run more tasks
+			if ((--client->credit == 0) || (client->ready == 0) || (client->running >= client->maxConcurrency)) {
+				schedule.pop_front();
+				client->scheduled = false;
+				client->credit = client->weight;
+				reschedule(client);
+			}
+
+			locker.unlock();
+			client->source->runTask(slots[static_cast<int>(client->kind)]);
+			locker.lock();
+
+			--client->running;
+			++client->executed;
+			reschedule(client);
+			if (client->running == 0)
+				idleCv.notify_all();
+		}
+		for (watchdog::ActivitySlot* slot : slots)
+			if (slot)
+				stallWatchdog->unregisterThread(slot);
+	};
+
+public:
+	/**
+	 * Class constructor. It starts the threads
+	 * @param[in] threadCount	Number of threads (the number of hardware threads if it is 0)
+	 * @param[in] watchdog		Watchdog which reports the tasks running for too long (optional)
+	 */
+	explicit SharedExecutor(const size_t threadCount = 0, const std::shared_ptr<watchdog::Watchdog>& watchdog = nullptr) :
+		stallWatchdog(watchdog), stop(false) {
+		const size_t count = (threadCount > 0) ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+		for (size_t i = 0; i < count; ++i)
+			threads.push_back(std::thread(&SharedExecutor::work, this));
+	};
+
+	/**
+	 * Class destructor. It waits for the threads, which finish once the ready tasks have been run.
+	 * The clients must have been detached
+	 */
+	virtual ~SharedExecutor() {
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			stop = true;
+		}
+		workCv.notify_all();
+		for (std::thread& thread : threads)
+			thread.join();
+	};
+
+	/**
+	 * Obtain the number of threads of the pool
+	 */
+	size_t getThreadCount() const {
+		return threads.size();
+	};
+
+	/**
+	 * Register a source of tasks
+	 * @param[in] source			Source of the tasks
+	 * @param[in] kind				Activity of the tasks, for the watchdog
+	 * @param[in] weight			Tasks run per turn (the share of the threads is proportional to it)
+	 * @param[in] maxConcurrency	Maximum number of tasks run concurrently
+	 * @return						Registration, valid until it is detached
+	 */
+	Client* attach(TaskSource* source, const watchdog::StallKind kind, const unsigned int weight = 1, const size_t maxConcurrency = SIZE_MAX) {
+		std::lock_guard<std::mutex> locker(mutex);
+		clients.emplace_back(source, kind, weight, maxConcurrency);
+		return &clients.back();
+	};
+
+	/**
+	 * Unregister a source. Its ready tasks are discarded and the call waits for the ones being run
+	 * @param[in] client	Registration of the source
+	 */
+	void detach(Client* client) {
+		std::unique_lock<std::mutex> locker(mutex);
+		client->ready = 0;
+		if (client->scheduled) {
+			// Remove the client from the schedule, keeping the order of the others
+			for (size_t i = schedule.size(); i > 0; --i) {
+				Client* scheduled = schedule.front();
+				schedule.pop_front();
+				if (scheduled != client)
+					schedule.push_back(scheduled);
+			}
+			client->scheduled = false;
+		}
+		idleCv.wait(locker, [&]{ return client->running == 0;});
+		clients.remove_if([client](const Client& candidate) { return &candidate == client;});
+	};
+
+	/**
+	 * Indicate that some tasks of a source are ready to be run
+	 * @param[in] client	Registration of the source
+	 * @param[in] count		Number of ready tasks
+	 */
+	void submit(Client* client, const size_t count = 1) {
+		std::lock_guard<std::mutex> locker(mutex);
+		client->ready += count;
+		if (!client->scheduled)
+			reschedule(client);
+		if (count > 1)
+			workCv.notify_all();
+	};
+
+	/**
+	 * Change the share of the threads given to a source
+	 * @param[in] client	Registration of the source
+	 * @param[in] weight	Tasks run per turn
+	 */
+	void setWeight(Client* client, const unsigned int weight) {
+		std::lock_guard<std::mutex> locker(mutex);
+		client->weight = std::max(weight, 1u);
+	};
+
+	/**
+	 * Obtain the number of tasks run for a source
+	 * @param[in] client	Registration of the source
+	 */
+	uint64_t getExecuted(const Client* client) {
+		std::lock_guard<std::mutex> locker(mutex);
+		return client->executed;
+	};
+};
+
+} /* namespace executor */
+} /* namespace proactor */
+
+#endif /* EXECUTOR_SHAREDEXECUTOR_HPP_ */
@@ -0,0 +1,39 @@
+/**
+ * @file TaskSource.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Component whose tasks are run by a shared executor.
+ */
+
+#ifndef EXECUTOR_TASKSOURCE_HPP_
+#define EXECUTOR_TASKSOURCE_HPP_
+
+#include "../watchdog/ActivitySlot.hpp"
+
+namespace proactor {
+namespace executor {
+
+/**
+ * This class is the interface of the components which do not own their threads, but have their tasks
+ * run by a shared executor: the processor (one task per ready operation) and the proactor (one task
+ * per completion to be dispatched). The source keeps its own queue of tasks and tells the executor how
+ * many are ready; the executor decides when each one is run.
+ * @see SharedExecutor
+ */
+class TaskSource {
+public:
+	virtual ~TaskSource() {
+	};
+
+	/**
+	 * Run the next ready task. It may find that there is nothing to do (e.g. the task has been
+	 * discarded meanwhile)
+	 * @param[in] slot	Slot where the activity of the thread is published (NULL if it is not watched)
+	 */
+	virtual void runTask(watchdog::ActivitySlot* slot) = 0;
+};
+
+} /* namespace executor */
+} /* namespace proactor */
+
+#endif /* EXECUTOR_TASKSOURCE_HPP_ */
@@ -0,0 +1,150 @@
+/**
+ * @file FileReductionDemo.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Sum of the 64-bit integers stored in a binary file, reduced in chunks by the workers. The program
+ * generates the file, sums it with each access mode (memory-mapped and streamed chunks) and checks
+ * the results against the sum computed while the file was generated. The completion handler
+ * releases each reduction, as a client would do.
+ * Usage: FileReductionDemo [MEGABYTES] [CHUNK_KB]
+ *   (default: a 32 MB file in chunks of 1024 KB)
+ * @see asyncOperation/FileReductionAsynchronousOperation
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../asyncOperation/FileReductionAsynchronousOperation.hpp"
+#include "../exception/IOException.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../logger/Logger.hpp"
+#include "../observer/Observer.hpp"
+
+using namespace proactor;
+
+/**
+ * Number of workers which reduce the chunks
+ */
+const size_t WORKERS = 4;
+
+/**
+ * Handler which obtains the result of a reduction and releases it
+ */
+class ReductionHandler : public observer::Observer<asyncOperation::AsynchronousOperation<int64_t> > {
+private:
+	/**
+	 * Result of the reduction (or the description of its error)
+	 */
+	std::promise<std::string> result;
+
+public:
+	/**
+	 * Obtain the result of the reduction, once it has been completed
+	 */
+	std::future<std::string> getResult() {
+		return result.get_future();
+	};
+
+	void notify(asyncOperation::AsynchronousOperation<int64_t>* operation) {
+		std::string value;
+		try {
+			value = utils::Utils::tostr(operation->getResult());
+		} catch (exception::IOException& e) {
+			value = e.getMessage();
+		}
+		// The reduction (and its chunks) are no longer used by the engine
+		delete operation;
+		result.set_value(value);
+	};
+};
+
+/**
+ * Generate a file of 64-bit integers
+ * @param[in] path	Path of the file
+ * @param[in] bytes	Size of the file
+ * @return			Sum of the integers
+ */
+int64_t generate(const std::string& path, const size_t bytes) {
+	std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+	std::vector<int64_t> block(1 << 16);
+	int64_t sum = 0, value = 0;
+	for (size_t written = 0; written < bytes; ) {
+		const size_t count = std::min(block.size(), (bytes - written) / sizeof(int64_t));
+		for (size_t i = 0; i < count; ++i) {
+			block[i] = (value++ % 2001) - 1000;
+			sum += block[i];
+		}
+		file.write(reinterpret_cast<const char*>(block.data()), count * sizeof(int64_t));
+		written += count * sizeof(int64_t);
+	}
+	return sum;
+}
+
+/**
+ * Sum a file by submitting the chunks of its reduction as a batch
+ * @param[in] name		Name of the access mode
+ * @param[in] path		Path of the file
+ * @param[in] mode		Access mode
+ * @param[in] chunkSize	Size of the chunks
+ * @param[in] expected	Expected sum
+ * @return				True if the sum is correct
+ */
+bool sum(const std::string& name, const std::string& path, const asyncOperation::FileAccessMode mode,
+		 const size_t chunkSize, const int64_t expected) {
+	ReductionHandler handler;
+	std::future<std::string> result = handler.getResult();
+	initiatorCompletion::InitiatorCompletion<int64_t> initiator(&handler, asyncOperation::CompletionMode::SERIALIZED, WORKERS);
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	size_t chunks = 0;
+	try {
+		// Released by the handler
+		asyncOperation::FileReductionAsynchronousOperation<int64_t>* reduction =
+				new asyncOperation::FileReductionAsynchronousOperation<int64_t>(path, mode, chunkSize);
+		chunks = reduction->getChunks().size();
+		initiator.processOperations(reduction->getChunks().begin(), reduction->getChunks().end());
+	} catch (exception::IOException& e) {
+		std::cerr << e.getMessage() << std::endl;
+		return false;
+	}
+	const std::string value = result.get();
+	const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	const bool correct = (value == utils::Utils::tostr(expected));
+	std::cout << std::left << std::setw(8) << name << std::right << std::setw(6) << chunks << " chunks  "
+			  << std::fixed << std::setprecision(1) << std::setw(8) << elapsed << " ms  sum " << value
+			  << (correct ? "" : "  WRONG") << std::endl;
+	return correct;
+}
+
+int main(int argc, char *argv[]) {
+	const size_t megabytes = (argc > 1) ? std::stoul(argv[1]) : 32;
+	const size_t chunkSize = ((argc > 2) ? std::stoul(argv[2]) : 1024) * 1024;
+	logger::Logger::setEnabled(false);
+
+	char path[] = "/tmp/FileReductionDemoXXXXXX";
+	const int fd = mkstemp(path);
+	if (fd < 0) {
+		std::cerr << "Cannot create the file of the demo" << std::endl;
+		return EXIT_FAILURE;
+	}
+	close(fd);
+	const int64_t expected = generate(path, megabytes << 20);
+	std::cout << "File of " << megabytes << " MB, expected sum " << expected << std::endl;
+
+	bool correct = sum("mmap", path, asyncOperation::FileAccessMode::MMAP, chunkSize, expected);
+	correct &= sum("stream", path, asyncOperation::FileAccessMode::STREAM, chunkSize, expected);
+	unlink(path);
+	std::cout << (correct ? "PASSED" : "FAILED: wrong sum") << std::endl;
+	return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -7,19 +7,45 @@
 #ifndef INITIATORCOMPLETION_INITIATORCOMPLETION_HPP_
 #define INITIATORCOMPLETION_INITIATORCOMPLETION_HPP_
 
+#include <chrono>
+#include <exception>
 #include <future>
+#include <iterator>
 #include <memory>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "../asyncOperationProcessor/AsynchronousOperationProcessor.hpp"
 #include "../completionEventQueue/CompletionEventQueue.hpp"
-#include "../logger/Logger.hpp"
+#include "../concurrencyController/ConcurrencyController.hpp"
+#include "../exception/UnknownOperationTypeException.hpp"
+#include "../journal/CompletionJournal.hpp"
+#include "../policy/Policies.hpp"
 #include "../proactor/Proactor.hpp"
+#include "../registry/OperationRegistry.hpp"
+#include "../trace/TraceRecorder.hpp"
 #include "../utils/Utils.hpp"
+#include "../watchdog/Watchdog.hpp"
 
 namespace proactor {
 namespace initiatorCompletion {
 
+/**
+ * Defines what happens to the operations which have not been started when the system is shut down
+ */
+enum class ShutdownMode {
+	/**
+	 * All the accepted operations are executed and their completions dispatched
+	 */
+	GRACEFUL,
+	/**
+	 * The accepted operations which have not been started are discarded. The ones being executed
+	 * are completed and dispatched
+	 */
+	ABORT_PENDING
+};
+
 /**
  * This class performs the Initiator and Completion tasks:
  * - Initiator: Starts the invocation of the asynchronous operation via the asynchronous operation processor
@@ -29,58 +55,175 @@ namespace initiatorCompletion {
  * @see completionEventQueue/CompletionEventQueue
  * @see asyncOperationProcessor/AsynchronousOperationProcessor
  * @see observer/Observer
+ * @tparam Policies	Compile-time configuration of the engine (see policy::Policies). With the
+ * 					CallerThreadExecutor, the operations are executed and notified before
+ * 					processOperation(s) returns, and no thread is started
  */
-template <typename T>
+template <typename T, typename Policies = policy::DefaultPolicies>
 class InitiatorCompletion : public observer::Observer<asyncOperation::AsynchronousOperation<T> > {
 
 private:
 	/**
 	 * This completion event queue contains the completed operations.
 	 */
-	std::shared_ptr<completionEventQueue::CompletionEventQueue<T> > completionEventQueue;
+	std::shared_ptr<completionEventQueue::CompletionEventQueue<T, Policies> > completionEventQueue;
 	/**
 	 * This is the processor of the operations. It also fills the completion event queue when an operation
 	 * is finished
 	 */
-	std::shared_ptr<asyncOperationProcessor::AsynchronousOperationProcessor<T> > asynchronousOperationProcessor;
+	std::shared_ptr<asyncOperationProcessor::AsynchronousOperationProcessor<T, Policies> > asynchronousOperationProcessor;
 	/**
 	 * Checks in background the status of the completion event queue and notifies this class
 	 * when an operation is completed
 	 */
-	std::unique_ptr<proactor::Proactor<T> > proactor;
+	std::unique_ptr<proactor::Proactor<T, Policies> > proactor;
 	/**
 	 * This is used only when we want to finish the system. It allows finishing correctly the initiator
 	 * completion by waiting until the proactor thread finishes
 	 */
-	std::future<void> proactorThread;
+	std::shared_future<void> proactorThread;
+	/**
+	 * Client handler which is notified once an operation has been completed (optional)
+	 */
+	observer::Observer<asyncOperation::AsynchronousOperation<T> >* completionHandler;
+	/**
+	 * Journal of the serializable operations (optional)
+	 */
+	std::shared_ptr<journal::CompletionJournal> completionJournal;
+	/**
+	 * Wait until the submissions are durable before handing them to the processor
+	 */
+	bool durableSubmissions;
+	/**
+	 * Operations replayed from the journal (they are owned by this class)
+	 */
+	std::vector<std::unique_ptr<asyncOperation::AsynchronousOperation<T> > > recoveredOperations;
+
+	/**
+	 * Record the submission of a set of operations in the journal (if any). Only the serializable
+	 * operations are recorded
+	 * @param[in] begin	Iterator to the first operation
+	 * @param[in] end	Iterator past the last operation
+	 * @throw exception::IOException if durable submissions are requested and the journal cannot be written
+	 */
+	template <typename Iterator>
+	void journalSubmissions(Iterator begin, Iterator end) {
+		if (!completionJournal)
+			return;
+		uint64_t sequence = 0;
+		for (Iterator iter = begin; iter != end; ++iter) {
+			asyncOperation::AsynchronousOperation<T>* operation = *iter;
+			const std::string typeName = operation->getTypeName();
+			if (!typeName.empty())
+				sequence = completionJournal->appendSubmission(operation->getId(), typeName, operation->serializeArguments());
+		}
+		// A single wait per batch: the records are made durable by the same group commit
+		if (durableSubmissions && (sequence > 0))
+			completionJournal->waitDurable(sequence);
+	};
+
+	/**
+	 * Start the shutdown of the system. Each step is idempotent and synchronized by the
+	 * component it belongs to
+	 * @param[in] mode	What to do with the operations which have not been started
+	 */
+	void requestShutdown(const ShutdownMode mode) {
+		// Reject new operations and wake up the threads waiting for a slot
+		asynchronousOperationProcessor->close();
+		if (mode == ShutdownMode::ABORT_PENDING) {
+			const size_t aborted = asynchronousOperationProcessor->abortPending();
+			if (aborted > 0)
+				Policies::Logging::log("Discarded " + utils::Utils::tostr(aborted) + " pending operations.");
+		}
+		// The proactor finishes once the last completion has been dispatched
+		proactor->canFinish(true);
+	};
 
 public:
 	/**
 	 * Class constructor
+	 * @param[in] completionHandler	Client handler to notify when an operation has been completed. This
+	 * 								parameter is optional
+	 * @param[in] completionMode	Completion mode for the operations which do not define their own one.
+	 * 								With CompletionMode::INLINE the handler is invoked in the worker threads
+	 * 								(i.e. concurrently), so it must be thread-safe
+	 * @param[in] poolSize			Maximum number of operations executed concurrently (the default pool size of
+	 * 								the processor if it is not defined)
+	 * @param[in] controller		Controller which adapts the number of operations executed concurrently. If
+	 * 								it is defined, the pool size is given by its maximum limit
+	 * @param[in] watchdog			Watchdog which reports the operations executing for too long and the completions
+	 * 								whose handler blocks the proactor thread. It can be shared by several engines
+	 * @param[in] executor			Shared executor which executes the operations and dispatches the completions,
+	 * 								so that several engines run on the same threads. If it is not defined, the
+	 * 								engine starts its own workers (poolSize) and proactor thread. The pool size
+	 * 								is still the maximum number of operations of this engine in flight
+	 * @see asyncOperation::CompletionMode
+	 * @see concurrencyController::ConcurrencyController
+	 * @see watchdog::Watchdog
+	 * @see executor::SharedExecutor
 	 */
-	InitiatorCompletion() :
-		completionEventQueue(std::shared_ptr<completionEventQueue::CompletionEventQueue<T> >(new completionEventQueue::CompletionEventQueue<T>())),
-		asynchronousOperationProcessor(std::make_shared<asyncOperationProcessor::AsynchronousOperationProcessor<T> >(completionEventQueue)),
-		proactor(std::unique_ptr<proactor::Proactor<T> >(new proactor::Proactor<T>(completionEventQueue, this)))
+	InitiatorCompletion(observer::Observer<asyncOperation::AsynchronousOperation<T> >* completionHandler = NULL,
+						const asyncOperation::CompletionMode completionMode = asyncOperation::CompletionMode::SERIALIZED,
+						const size_t poolSize = asyncOperationProcessor::AsynchronousOperationProcessor<T, Policies>::DEFAULT_QUEUE_SIZE,
+						const std::shared_ptr<concurrencyController::ConcurrencyController>& controller = nullptr,
+						const std::shared_ptr<watchdog::Watchdog>& watchdog = nullptr,
+						const std::shared_ptr<executor::SharedExecutor>& executor = nullptr) :
+		completionEventQueue(std::shared_ptr<completionEventQueue::CompletionEventQueue<T, Policies> >(new completionEventQueue::CompletionEventQueue<T, Policies>())),
+		asynchronousOperationProcessor(std::make_shared<asyncOperationProcessor::AsynchronousOperationProcessor<T, Policies> >(completionEventQueue,
+				poolSize, this, completionMode, controller, watchdog, executor)),
+		proactor(std::unique_ptr<proactor::Proactor<T, Policies> >(new proactor::Proactor<T, Policies>(completionEventQueue, this, watchdog))),
+		completionHandler(completionHandler),
+		durableSubmissions(true)
 	{
-		// Start the proactor
-		proactorThread = std::async(std::launch::async, &proactor::Proactor<T>::exec, proactor.get());
+		if (Policies::Executor::CALLER_THREAD) {
+			// All the completions are dispatched in the caller thread: there is nothing to wait for
+			std::promise<void> finished;
+			finished.set_value();
+			proactorThread = finished.get_future().share();
+		} else if (executor) {
+			// The completions are dispatched by the shared executor
+			proactorThread = proactor->attach(executor);
+		} else {
+			// Start the proactor
+			proactorThread = std::async(std::launch::async, &proactor::Proactor<T, Policies>::exec, proactor.get()).share();
+		}
 	};
 
 	/**
-	 * Class destructor
+	 * Class destructor. It shuts down the system gracefully (if it has not been done before).
 	 */
 	virtual ~InitiatorCompletion() {
-		// Verify that all operations have been processed
-		while (completionEventQueue->size() != 0) {
-			logger::Logger::log("Waiting for last elements...: " + utils::Utils::tostr(completionEventQueue->size()));
-			std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-		}
-		// Tell the proactor to finish
-		proactor->canFinish(true);
-		// Wait until the proactor finishes
-		proactorThread.wait();
-		logger::Logger::log("Finished InitiatorCompletion.");
+		shutdown(ShutdownMode::GRACEFUL);
+		Policies::Logging::log("Finished InitiatorCompletion.");
+	};
+
+	/**
+	 * Shut down the system: new operations are rejected, waiting threads are woken up and the
+	 * call returns as soon as the last completion has been dispatched. It can be called several
+	 * times and from several threads (e.g. to escalate a graceful shutdown to an abort).
+	 * @param[in] mode	What to do with the operations which have not been started
+	 * @see ShutdownMode
+	 */
+	void shutdown(const ShutdownMode mode) {
+		requestShutdown(mode);
+		// Copy the future, as it is waited from the calling thread
+		std::shared_future<void> finished = proactorThread;
+		finished.wait();
+	};
+
+	/**
+	 * Shut down the system with a deadline.
+	 * @param[in] mode		What to do with the operations which have not been started
+	 * @param[in] timeout	Maximum time to wait for the last completion to be dispatched
+	 * @return				True if the system has been drained before the deadline. Otherwise, the
+	 * 						shutdown goes on in background (and the destructor waits for it)
+	 * @see ShutdownMode
+	 */
+	template <typename Rep, typename Period>
+	bool shutdown(const ShutdownMode mode, const std::chrono::duration<Rep, Period>& timeout) {
+		requestShutdown(mode);
+		std::shared_future<void> finished = proactorThread;
+		return finished.wait_for(timeout) == std::future_status::ready;
 	};
 
 	/**
@@ -88,21 +231,165 @@ public:
 	 * which decides whether the operation can be processed or keeps waiting until an slot is
 	 * available
 	 * @param[in] operation	Operation to be processed
+	 * @throw exception::ShutdownException if the system is being shut down
 	 */
 	void processOperation(asyncOperation::AsynchronousOperation<T> *operation) {
-		logger::Logger::log("Initiating operation " + utils::Utils::tostr(operation->getId()) + "... ");
+		if (Policies::Logging::isEnabled())
+			Policies::Logging::log("Initiating operation " + utils::Utils::tostr(operation->getId()) + "... ");
+		journalSubmissions(&operation, &operation + 1);
 		asynchronousOperationProcessor->addOperation(operation);
 	};
 
+	/**
+	 * Add a set of operations to the system. All of them are handed to the AsynchronousOperationProcessor
+	 * at once, so the synchronization cost is paid per batch rather than per operation. As with
+	 * processOperation, the call waits until all the operations have got a slot in the processor.
+	 * The range is traversed more than once (the journal records the submissions before they are
+	 * handed to the processor), so the iterators must be forward iterators.
+	 * @param[in] begin	Iterator to the first operation to be processed (AsynchronousOperation<T>*)
+	 * @param[in] end	Iterator past the last operation to be processed
+	 * @throw exception::ShutdownException if the system is being shut down
+	 */
+	template <typename Iterator>
+	void processOperations(Iterator begin, Iterator end) {
+		static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value,
+				"processOperations traverses the range several times: it requires forward iterators");
+		if (Policies::Logging::isEnabled())
+			Policies::Logging::log("Initiating " + utils::Utils::tostr(std::distance(begin, end)) + " operations... ");
+		journalSubmissions(begin, end);
+		asynchronousOperationProcessor->addOperations(begin, end);
+	};
+
+	/**
+	 * Set the journal where the submissions and completions of the serializable operations are
+	 * recorded. It must be set before any operation is processed.
+	 * @param[in] journal				Journal of the operations
+	 * @param[in] durableSubmissions	If true, processOperation(s) waits until the submissions are durable
+	 * 									(one group commit per call), so that an accepted operation is never lost.
+	 * 									Otherwise, the submissions are made durable in background
+	 * @see journal::CompletionJournal
+	 */
+	void setJournal(const std::shared_ptr<journal::CompletionJournal>& journal, const bool durableSubmissions = true) {
+		this->completionJournal = journal;
+		this->durableSubmissions = durableSubmissions;
+	};
+
+	/**
+	 * Replay the operations of the journal which were submitted in a previous run but not completed.
+	 * They are created with the registry, recorded as new submissions and processed as a batch.
+	 * @param[in] registry	Registry of the types of operations
+	 * @return				Replayed operations. They are owned by this class and live as long as it does.
+	 * 						The submissions whose type is not registered or whose arguments cannot be
+	 * 						deserialized are skipped (and kept in the journal)
+	 * @throw exception::ShutdownException if the system is being shut down
+	 * @throw exception::IOException if the journal cannot be written
+	 */
+	std::vector<asyncOperation::AsynchronousOperation<T>*> recover(const registry::OperationRegistry<T>& registry) {
+		std::vector<asyncOperation::AsynchronousOperation<T>*> operations;
+		if (!completionJournal)
+			return operations;
+		uint64_t sequence = 0;
+		for (const journal::CompletionJournal::Entry& entry : completionJournal->getUnfinished()) {
+			std::unique_ptr<asyncOperation::AsynchronousOperation<T> > operation;
+			try {
+				operation = registry.create(entry.typeName, entry.arguments);
+			} catch (exception::UnknownOperationTypeException& e) {
+				Policies::Logging::log(e.getMessage() + " - operation not replayed");
+				continue;
+			} catch (std::exception& e) {
+				// A corrupt record must not prevent the other ones from being replayed (nor the next restarts)
+				Policies::Logging::log("Invalid arguments of a " + entry.typeName + " operation (" + e.what() + ") - operation not replayed");
+				continue;
+			}
+			sequence = completionJournal->appendReplay(entry, operation->getId());
+			operations.push_back(operation.get());
+			recoveredOperations.push_back(std::move(operation));
+		}
+		if (sequence > 0)
+			completionJournal->waitDurable(sequence);
+		Policies::Logging::log("Replaying " + utils::Utils::tostr(operations.size()) + " operations... ");
+		asynchronousOperationProcessor->addOperations(operations.begin(), operations.end());
+		return operations;
+	};
+
+	/**
+	 * Enable the deduplication of the operations with a content key (singleflight and, optionally,
+	 * a cache of results). It must be set before any operation is processed.
+	 * @param[in] enabled		Indicates whether the operations are deduplicated
+	 * @param[in] cacheCapacity	Maximum number of cached results (0 disables the cache)
+	 * @see asyncOperationProcessor::AsynchronousOperationProcessor::setDeduplication
+	 */
+	void setDeduplication(const bool enabled, const size_t cacheCapacity = 0) {
+		asynchronousOperationProcessor->setDeduplication(enabled, cacheCapacity);
+	};
+
+	/**
+	 * Obtain the counters of the deduplication (hits and misses of the cache, coalesced operations)
+	 */
+	asyncOperationProcessor::DeduplicationStatistics getDeduplicationStatistics() {
+		return asynchronousOperationProcessor->getDeduplicationStatistics();
+	};
+
+	/**
+	 * Obtain the metrics collected by the processor
+	 * @see policy::MetricsPolicy
+	 */
+	const typename Policies::Metrics& getMetrics() const {
+		return asynchronousOperationProcessor->getMetrics();
+	};
+
+	/**
+	 * Summarize the operations accepted by the processor and not completed yet
+	 * @see operationTable::InFlightStatistics
+	 */
+	operationTable::InFlightStatistics getInFlightStatistics() {
+		return asynchronousOperationProcessor->getInFlightStatistics();
+	};
+
+	/**
+	 * Set the share of the threads of the shared executor given to this engine, relative to the other
+	 * engines which share it (1 by default). It has no effect without a shared executor
+	 * @param[in] weight	Operations executed per turn
+	 */
+	void setExecutorWeight(const unsigned int weight) {
+		asynchronousOperationProcessor->setExecutorWeight(weight);
+	};
+
+	/**
+	 * Obtain the current concurrency limit of the processor
+	 * @return	Maximum number of operations executed concurrently
+	 */
+	size_t getConcurrencyLimit() {
+		return asynchronousOperationProcessor->getConcurrencyLimit();
+	};
+
 	/**
 	 * Notify that an operation has been completed
 	 * @param[in] operation	Completed operation
 	 */
 	void notify(asyncOperation::AsynchronousOperation<T> *operation) {
-		logger::Logger::log("Notified in Initiator/Completion - id:" +
-				utils::Utils::tostr(operation->getId()) +
-				" - Result operation: " +
-				utils::Utils::tostr(operation->getResult()));
+		trace::traceEvent(trace::TraceEvent::NOTIFY, operation->getId());
+		if (Policies::Logging::isEnabled()) {
+			// The result might not be available (e.g. the operation has failed)
+			std::string result;
+			try {
+				result = utils::Utils::tostr(operation->getResult());
+			} catch (std::exception&) {
+				result = "not available";
+			}
+			Policies::Logging::log("Notified in Initiator/Completion - id:" +
+					utils::Utils::tostr(operation->getId()) +
+					" - Result operation: " + result);
+		}
+		// Read before the client handles the completion, as its handler may release the operation
+		const bool journaled = completionJournal && !operation->getTypeName().empty();
+		const unsigned long long id = operation->getId();
+		// Forward the completion to the client
+		if (completionHandler != NULL)
+			completionHandler->notify(operation);
+		// Recorded once the client has handled it: a crash before this point replays the operation
+		if (journaled)
+			completionJournal->appendCompletion(id);
 		// NOTE: Add these lines in case you want to avoid that the client removes
 		//       the operation pointers
 		// Remove operation as it was finished
@@ -0,0 +1,59 @@
+/**
+ * @file Futex.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Wait and wake up threads of different processes on a word of shared memory.
+ */
+
+#ifndef IPC_FUTEX_HPP_
+#define IPC_FUTEX_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace proactor {
+namespace ipc {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && ATOMIC_INT_LOCK_FREE == 2,
+		"The futex words must be plain lock-free 32-bit integers");
+
+/**
+ * This class wraps the futex system call. The futexes are not private, so the word can be in
+ * memory shared between processes.
+ */
+class Futex {
+public:
+	/**
+	 * Wait while a word has a given value
+	 * @param[in] word		Word of (shared) memory
+	 * @param[in] expected	The thread only sleeps if the word still has this value
+	 * @param[in] timeout	Maximum time to wait
+	 * @note It may return spuriously: the caller has to check its condition again
+	 */
+	static void wait(std::atomic<uint32_t>& word, const uint32_t expected, const std::chrono::nanoseconds& timeout) {
+		struct timespec time;
+		time.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+		time.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &time, NULL, 0);
+	};
+
+	/**
+	 * Wake up the threads waiting on a word
+	 * @param[in] word		Word of (shared) memory
+	 * @param[in] count		Maximum number of threads to wake up
+	 */
+	static void wake(std::atomic<uint32_t>& word, const int count = 1) {
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, count, NULL, NULL, 0);
+	};
+};
+
+} /* namespace ipc */
+} /* namespace proactor */
+
+#endif /* IPC_FUTEX_HPP_ */
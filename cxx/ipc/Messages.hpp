@@ -0,0 +1,113 @@
+/**
+ * @file Messages.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Messages exchanged through the rings of a shared memory channel.
+ */
+
+#ifndef IPC_MESSAGES_HPP_
+#define IPC_MESSAGES_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace proactor {
+namespace ipc {
+
+/**
+ * Request to execute an operation, sent by the client
+ */
+struct Submission {
+	/**
+	 * Value chosen by the client to match the completion (e.g. an index or a pointer)
+	 */
+	uint64_t userData;
+	/**
+	 * Name of the type of the operation (see registry::OperationRegistry)
+	 */
+	std::string typeName;
+	/**
+	 * Serialized arguments of the operation
+	 */
+	std::string arguments;
+
+	/**
+	 * Encode the submission: [userData][type length (u16)][type][arguments]
+	 */
+	void encode(std::string& message) const {
+		const uint16_t typeLength = static_cast<uint16_t>(typeName.size());
+		message.resize(sizeof(userData) + sizeof(typeLength));
+		std::memcpy(&message[0], &userData, sizeof(userData));
+		std::memcpy(&message[sizeof(userData)], &typeLength, sizeof(typeLength));
+		message.append(typeName);
+		message.append(arguments);
+	};
+
+	/**
+	 * Decode a submission
+	 * @return	False if the message is malformed
+	 */
+	bool decode(const std::string& message) {
+		uint16_t typeLength;
+		if (message.size() < sizeof(userData) + sizeof(typeLength))
+			return false;
+		std::memcpy(&userData, message.data(), sizeof(userData));
+		std::memcpy(&typeLength, message.data() + sizeof(userData), sizeof(typeLength));
+		const size_t start = sizeof(userData) + sizeof(typeLength);
+		if (message.size() - start < typeLength)
+			return false;
+		typeName.assign(message, start, typeLength);
+		arguments.assign(message, start + typeLength, std::string::npos);
+		return true;
+	};
+};
+
+/**
+ * Completion of an operation, sent by the proactor process
+ */
+struct Completion {
+	/**
+	 * Value of the submission
+	 */
+	uint64_t userData;
+	/**
+	 * Indicates whether the operation has been executed. Otherwise, the result is the reason
+	 */
+	bool succeeded;
+	/**
+	 * Result of the operation (as text)
+	 */
+	std::string result;
+
+	/**
+	 * Encode the completion: [userData][succeeded (u8)][result]
+	 */
+	void encode(std::string& message) const {
+		const uint8_t status = succeeded ? 1 : 0;
+		message.resize(sizeof(userData) + sizeof(status));
+		std::memcpy(&message[0], &userData, sizeof(userData));
+		std::memcpy(&message[sizeof(userData)], &status, sizeof(status));
+		message.append(result);
+	};
+
+	/**
+	 * Decode a completion
+	 * @return	False if the message is malformed
+	 */
+	bool decode(const std::string& message) {
+		uint8_t status;
+		if (message.size() < sizeof(userData) + sizeof(status))
+			return false;
+		std::memcpy(&userData, message.data(), sizeof(userData));
+		std::memcpy(&status, message.data() + sizeof(userData), sizeof(status));
+		succeeded = (status != 0);
+		result.assign(message, sizeof(userData) + sizeof(status), std::string::npos);
+		return true;
+	};
+};
+
+} /* namespace ipc */
+} /* namespace proactor */
+
+#endif /* IPC_MESSAGES_HPP_ */
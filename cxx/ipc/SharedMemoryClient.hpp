@@ -0,0 +1,93 @@
+/**
+ * @file SharedMemoryClient.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Client side of a shared memory channel to a proactor process.
+ */
+
+#ifndef IPC_SHAREDMEMORYCLIENT_HPP_
+#define IPC_SHAREDMEMORYCLIENT_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "Messages.hpp"
+#include "SharedMemorySegment.hpp"
+#include "SharedRing.hpp"
+
+namespace proactor {
+namespace ipc {
+
+/**
+ * This class submits operations to a proactor process (see SharedMemoryServer) and retrieves their
+ * completions, through the rings of a shared memory segment. The rings have a single producer and a
+ * single consumer: the operations must be submitted from one thread, and the completions retrieved
+ * from one thread (which may be another one).
+ */
+class SharedMemoryClient {
+private:
+	/**
+	 * Segment of the channel
+	 */
+	SharedMemorySegment segment;
+	/**
+	 * Ring of the submissions (this side is the producer)
+	 */
+	SharedRing submissions;
+	/**
+	 * Ring of the completions (this side is the consumer)
+	 */
+	SharedRing completions;
+	/**
+	 * Buffers reused by the submissions and completions
+	 */
+	std::string submissionBuffer;
+	std::string completionBuffer;
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] name	Name of the channel (shared memory object created by the server)
+	 * @throw exception::IOException if the channel does not exist
+	 */
+	explicit SharedMemoryClient(const std::string& name) : segment(name),
+			submissions(segment.getSubmissionRing()), completions(segment.getCompletionRing()) {
+	};
+
+	/**
+	 * Submit an operation
+	 * @param[in] submission	Operation to execute
+	 * @param[in] timeout		Maximum time to wait while the submission ring is full
+	 * @return					False if the ring is still full after the timeout
+	 * @throw std::invalid_argument if the submission does not fit in a slot of the ring
+	 */
+	bool submit(const Submission& submission, const std::chrono::nanoseconds& timeout = std::chrono::seconds(1)) {
+		submission.encode(submissionBuffer);
+		return submissions.push(submissionBuffer.data(), submissionBuffer.size(), timeout);
+	};
+
+	/**
+	 * Retrieve the next completion, if there is any
+	 * @param[out] completion	Completion of an operation
+	 * @return					False if there is no completion available
+	 */
+	bool tryComplete(Completion& completion) {
+		return completions.tryPop(completionBuffer) && completion.decode(completionBuffer);
+	};
+
+	/**
+	 * Retrieve the next completion, waiting for it
+	 * @param[out] completion	Completion of an operation
+	 * @param[in] timeout		Maximum time to wait
+	 * @return					False if there is no completion after the timeout
+	 */
+	bool complete(Completion& completion, const std::chrono::nanoseconds& timeout = std::chrono::seconds(1)) {
+		return completions.pop(completionBuffer, timeout) && completion.decode(completionBuffer);
+	};
+};
+
+} /* namespace ipc */
+} /* namespace proactor */
+
+#endif /* IPC_SHAREDMEMORYCLIENT_HPP_ */
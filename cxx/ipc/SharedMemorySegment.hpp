@@ -0,0 +1,197 @@
+/**
+ * @file SharedMemorySegment.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Shared memory segment with the submission and completion rings of a channel between a
+ * client process and the proactor process.
+ */
+
+#ifndef IPC_SHAREDMEMORYSEGMENT_HPP_
+#define IPC_SHAREDMEMORYSEGMENT_HPP_
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../exception/IOException.hpp"
+#include "SharedRing.hpp"
+
+namespace proactor {
+namespace ipc {
+
+/**
+ * This class maps a POSIX shared memory object (shm_open) which contains a submission ring (client
+ * to proactor) and a completion ring (proactor to client). The proactor process creates the segment
+ * and removes it when it is destroyed; the client attaches to it by name. The layout of the rings
+ * is kept in this process (given to the creator, checked against the size of the segment when
+ * attaching), so the other process cannot move them by writing into the segment.
+ * @see SharedRing
+ */
+class SharedMemorySegment {
+private:
+	/**
+	 * Layout of the beginning of the segment (followed by the rings)
+	 */
+	struct Header {
+		/**
+		 * Written last by the creator, once the rings have been initialized
+		 */
+		std::atomic<uint64_t> magic;
+	};
+
+	/**
+	 * Identifies an initialized segment (and the version of its layout)
+	 */
+	static const uint64_t MAGIC = 0x50524f4143540002ULL;
+	/**
+	 * Size of the header (a cache line, so that the rings are aligned). The submission ring follows
+	 * it, and the completion ring follows the submission ring
+	 */
+	static const size_t HEADER_SIZE = 64;
+
+	/**
+	 * Name of the shared memory object
+	 */
+	const std::string name;
+	/**
+	 * Indicates whether this process has created the segment (and has to remove it)
+	 */
+	const bool owner;
+	/**
+	 * Mapped memory
+	 */
+	void* memory;
+	/**
+	 * Size of the mapped memory
+	 */
+	size_t length;
+	/**
+	 * Number of slots of each ring
+	 */
+	uint32_t capacity;
+	/**
+	 * Size of the slots of each ring
+	 */
+	uint32_t slotSize;
+
+	/**
+	 * Map a shared memory object
+	 */
+	void map(const int fd) {
+		memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (memory == MAP_FAILED)
+			throw exception::IOException("Cannot map the shared memory " + name + ": " + std::strerror(errno));
+	};
+
+	/**
+	 * Obtain the header of the segment
+	 */
+	Header* header() const {
+		return static_cast<Header*>(memory);
+	};
+
+public:
+	/**
+	 * Create a segment. A previous segment with the same name (e.g. left by a crashed process) is replaced
+	 * @param[in] name		Name of the shared memory object (e.g. "/proactor")
+	 * @param[in] capacity	Number of slots of each ring (power of two)
+	 * @param[in] slotSize	Size of each slot (multiple of 8), which bounds the size of the messages
+	 * @throw exception::IOException if the segment cannot be created
+	 */
+	SharedMemorySegment(const std::string& name, const uint32_t capacity, const uint32_t slotSize) :
+		name(name), owner(true), memory(MAP_FAILED),
+		length(HEADER_SIZE + 2 * SharedRing::size(capacity, slotSize)), capacity(capacity), slotSize(slotSize) {
+		static_assert(sizeof(Header) <= HEADER_SIZE, "The header does not fit");
+		const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (fd < 0)
+			throw exception::IOException("Cannot create the shared memory " + name + ": " + std::strerror(errno));
+		if (ftruncate(fd, length) != 0) {
+			close(fd);
+			shm_unlink(name.c_str());
+			throw exception::IOException("Cannot size the shared memory " + name + ": " + std::strerror(errno));
+		}
+		map(fd);
+
+		Header* header = new (memory) Header();
+		SharedRing::initialize(static_cast<char*>(memory) + HEADER_SIZE, capacity, slotSize);
+		SharedRing::initialize(static_cast<char*>(memory) + HEADER_SIZE + SharedRing::size(capacity, slotSize), capacity, slotSize);
+		header->magic.store(MAGIC, std::memory_order_release);
+	};
+
+	/**
+	 * Attach to a segment created by another process
+	 * @param[in] name	Name of the shared memory object
+	 * @throw exception::IOException if the segment does not exist, is not initialized or its rings
+	 * 		  do not fit in it
+	 */
+	explicit SharedMemorySegment(const std::string& name) : name(name), owner(false), memory(MAP_FAILED), length(0),
+			capacity(0), slotSize(0) {
+		const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+		if (fd < 0)
+			throw exception::IOException("Cannot open the shared memory " + name + ": " + std::strerror(errno));
+		struct stat status;
+		if ((fstat(fd, &status) != 0) || (static_cast<size_t>(status.st_size) < HEADER_SIZE)) {
+			close(fd);
+			throw exception::IOException("The shared memory " + name + " is not initialized");
+		}
+		length = status.st_size;
+		map(fd);
+		if (header()->magic.load(std::memory_order_acquire) != MAGIC) {
+			munmap(memory, length);
+			throw exception::IOException("The shared memory " + name + " is not initialized");
+		}
+		// Both rings have the geometry of the first one
+		try {
+			const SharedRing ring(static_cast<char*>(memory) + HEADER_SIZE);
+			capacity = ring.getCapacity();
+			slotSize = ring.getSlotSize();
+		} catch (std::invalid_argument&) {
+			// The capacity is left at 0, so the segment is rejected below
+		}
+		if ((capacity == 0) || (HEADER_SIZE + 2 * SharedRing::size(capacity, slotSize) > length)) {
+			munmap(memory, length);
+			throw exception::IOException("The rings of the shared memory " + name + " are not valid");
+		}
+	};
+
+	SharedMemorySegment(const SharedMemorySegment&) = delete;
+	SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+	/**
+	 * Class destructor. It unmaps the segment, and removes it if this process created it
+	 */
+	virtual ~SharedMemorySegment() {
+		munmap(memory, length);
+		if (owner)
+			shm_unlink(name.c_str());
+	};
+
+	/**
+	 * Obtain the ring of the submissions (produced by the client)
+	 */
+	SharedRing getSubmissionRing() const {
+		return SharedRing(static_cast<char*>(memory) + HEADER_SIZE, capacity, slotSize);
+	};
+
+	/**
+	 * Obtain the ring of the completions (produced by the proactor process)
+	 */
+	SharedRing getCompletionRing() const {
+		return SharedRing(static_cast<char*>(memory) + HEADER_SIZE + SharedRing::size(capacity, slotSize), capacity, slotSize);
+	};
+};
+
+} /* namespace ipc */
+} /* namespace proactor */
+
+#endif /* IPC_SHAREDMEMORYSEGMENT_HPP_ */
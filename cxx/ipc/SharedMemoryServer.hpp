@@ -0,0 +1,240 @@
+/**
+ * @file SharedMemoryServer.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Proactor side of a shared memory channel: it executes the operations submitted by a client
+ * process and sends back their completions.
+ */
+
+#ifndef IPC_SHAREDMEMORYSERVER_HPP_
+#define IPC_SHAREDMEMORYSERVER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../exception/ShutdownException.hpp"
+#include "../exception/UnknownOperationTypeException.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../observer/Observer.hpp"
+#include "../policy/Policies.hpp"
+#include "../registry/OperationRegistry.hpp"
+#include "../utils/Utils.hpp"
+#include "Messages.hpp"
+#include "SharedMemorySegment.hpp"
+#include "SharedRing.hpp"
+
+namespace proactor {
+namespace ipc {
+
+/**
+ * This class creates a shared memory channel and serves the operations submitted through it (in
+ * the style of io_uring): a reader thread takes the submissions from the submission ring, creates
+ * the operations with the registry and processes them with its own InitiatorCompletion; the
+ * completions are put in the completion ring. The operations are owned by this class and released
+ * once their completion has been sent.
+ * A client which does not retrieve its completions eventually blocks the dispatch of the completions
+ * (the completion ring is full), so the back pressure reaches the submissions too.
+ * @see SharedMemoryClient
+ * @see registry::OperationRegistry
+ */
+template <typename T, typename Policies = policy::DefaultPolicies>
+class SharedMemoryServer : public observer::Observer<asyncOperation::AsynchronousOperation<T> > {
+private:
+	/**
+	 * Maximum time the reader sleeps before checking whether it has to finish
+	 */
+	static const unsigned int POLL_INTERVAL = 100;
+
+	/**
+	 * Registry of the types of operations which can be submitted
+	 */
+	const registry::OperationRegistry<T>& registry;
+	/**
+	 * Segment of the channel
+	 */
+	SharedMemorySegment segment;
+	/**
+	 * Ring of the submissions (this side is the consumer)
+	 */
+	SharedRing submissions;
+	/**
+	 * Ring of the completions (this side is the producer)
+	 */
+	SharedRing completions;
+	/**
+	 * The completion ring has a single producer: the completions are sent one at a time
+	 */
+	std::mutex completionMutex;
+	/**
+	 * Buffer reused by the completions
+	 */
+	std::string completionBuffer;
+	/**
+	 * Lock of the operations being processed
+	 */
+	std::mutex operationsMutex;
+	/**
+	 * Operations being processed, with the user data of their submission
+	 */
+	std::unordered_map<const asyncOperation::AsynchronousOperation<T>*,
+		std::pair<uint64_t, std::unique_ptr<asyncOperation::AsynchronousOperation<T> > > > operations;
+	/**
+	 * Indicates that the reader has to finish
+	 */
+	std::atomic<bool> stop;
+	/**
+	 * Engine which processes the operations
+	 */
+	initiatorCompletion::InitiatorCompletion<T, Policies> initiator;
+	/**
+	 * Thread which takes the submissions
+	 */
+	std::thread reader;
+
+	/**
+	 * Put a completion in the completion ring, waiting while it is full (unless the server is
+	 * being destroyed)
+	 */
+	void send(const Completion& completion) {
+		std::lock_guard<std::mutex> locker(completionMutex);
+		completion.encode(completionBuffer);
+		while (!completions.push(completionBuffer.data(), completionBuffer.size(), std::chrono::milliseconds(POLL_INTERVAL))) {
+			if (stop.load()) {
+				logger::Logger::log("Completion " + utils::Utils::tostr(completion.userData) + " not delivered: the client does not consume them");
+				return;
+			}
+		}
+	};
+
+	/**
+	 * Main loop of the reader thread
+	 */
+	void read() {
+		std::string message;
+		Submission submission;
+		while (!stop.load()) {
+			if (!submissions.pop(message, std::chrono::milliseconds(POLL_INTERVAL)))
+				continue;
+			if (!submission.decode(message)) {
+				logger::Logger::log("Malformed submission discarded");
+				continue;
+			}
+
+			std::unique_ptr<asyncOperation::AsynchronousOperation<T> > operation;
+			try {
+				operation = registry.create(submission.typeName, submission.arguments);
+			} catch (exception::UnknownOperationTypeException& e) {
+				send(Completion{submission.userData, false, e.getMessage()});
+				continue;
+			} catch (std::exception&) {
+				send(Completion{submission.userData, false, "Invalid arguments for " + submission.typeName});
+				continue;
+			}
+
+			asyncOperation::AsynchronousOperation<T>* pointer = operation.get();
+			{
+				std::lock_guard<std::mutex> locker(operationsMutex);
+				operations[pointer] = std::make_pair(submission.userData, std::move(operation));
+			}
+			try {
+				initiator.processOperation(pointer);
+			} catch (exception::ShutdownException&) {
+				{
+					std::lock_guard<std::mutex> locker(operationsMutex);
+					operations.erase(pointer);
+				}
+				send(Completion{submission.userData, false, "Shutting down"});
+			}
+		}
+	};
+
+public:
+	/**
+	 * Default number of slots of each ring
+	 */
+	static const uint32_t DEFAULT_CAPACITY = 1024;
+	/**
+	 * Default size of the slots (which bounds the size of the submissions and completions)
+	 */
+	static const uint32_t DEFAULT_SLOT_SIZE = 256;
+
+	/**
+	 * Class constructor. It creates the channel and starts serving it
+	 * @param[in] name				Name of the channel (shared memory object, e.g. "/proactor")
+	 * @param[in] registry			Registry of the types of operations which can be submitted (it must
+	 * 								outlive the server)
+	 * @param[in] capacity			Number of slots of each ring (power of two)
+	 * @param[in] slotSize			Size of each slot (multiple of 8)
+	 * @param[in] poolSize			Maximum number of operations executed concurrently
+	 * @throw exception::IOException if the channel cannot be created
+	 */
+	SharedMemoryServer(const std::string& name,
+					   const registry::OperationRegistry<T>& registry,
+					   const uint32_t capacity = DEFAULT_CAPACITY,
+					   const uint32_t slotSize = DEFAULT_SLOT_SIZE,
+					   const size_t poolSize = asyncOperationProcessor::AsynchronousOperationProcessor<T, Policies>::DEFAULT_QUEUE_SIZE) :
+						   registry(registry),
+						   segment(name, capacity, slotSize),
+						   submissions(segment.getSubmissionRing()),
+						   completions(segment.getCompletionRing()),
+						   stop(false),
+						   initiator(this, asyncOperation::CompletionMode::SERIALIZED, poolSize) {
+		reader = std::thread(&SharedMemoryServer<T, Policies>::read, this);
+	};
+
+	/**
+	 * Class destructor. It stops taking submissions, waits for the operations being processed and
+	 * removes the channel
+	 */
+	virtual ~SharedMemoryServer() {
+		stop.store(true);
+		submissions.wakeConsumer();
+		reader.join();
+		initiator.shutdown(initiatorCompletion::ShutdownMode::GRACEFUL);
+	};
+
+	/**
+	 * Send the completion of an operation to the client
+	 * @param[in] operation	Completed operation
+	 */
+	void notify(asyncOperation::AsynchronousOperation<T>* operation) {
+		std::pair<uint64_t, std::unique_ptr<asyncOperation::AsynchronousOperation<T> > > entry;
+		{
+			std::lock_guard<std::mutex> locker(operationsMutex);
+			typename std::unordered_map<const asyncOperation::AsynchronousOperation<T>*,
+				std::pair<uint64_t, std::unique_ptr<asyncOperation::AsynchronousOperation<T> > > >::iterator iter = operations.find(operation);
+			if (iter == operations.end())
+				return;
+			entry = std::move(iter->second);
+			operations.erase(iter);
+		}
+		Completion completion{entry.first, true, std::string()};
+		try {
+			completion.result = utils::Utils::tostr(operation->getResult());
+		} catch (std::exception&) {
+			completion.succeeded = false;
+			completion.result = "Operation failed";
+		}
+		send(completion);
+	};
+};
+
+template <typename T, typename Policies>
+const unsigned int SharedMemoryServer<T, Policies>::POLL_INTERVAL;
+template <typename T, typename Policies>
+const uint32_t SharedMemoryServer<T, Policies>::DEFAULT_CAPACITY;
+template <typename T, typename Policies>
+const uint32_t SharedMemoryServer<T, Policies>::DEFAULT_SLOT_SIZE;
+
+} /* namespace ipc */
+} /* namespace proactor */
+
+#endif /* IPC_SHAREDMEMORYSERVER_HPP_ */
@@ -0,0 +1,277 @@
+/**
+ * @file SharedRing.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Lock-free ring of messages which can be placed in memory shared between processes.
+ */
+
+#ifndef IPC_SHAREDRING_HPP_
+#define IPC_SHAREDRING_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include "Futex.hpp"
+
+namespace proactor {
+namespace ipc {
+
+/**
+ * This class is a view of a single-producer single-consumer ring of fixed-size slots, each one
+ * with a message of variable length. The producer and the consumer may be in different processes.
+ * The fast path does not make any system call: the head (consumer) and the tail (producer) are
+ * published with release/acquire atomic operations. A side only sleeps (on a futex) when the ring
+ * is empty (consumer) or full (producer), and announces it, so that the other side only makes the
+ * wake-up system call when somebody is sleeping.
+ * The memory may be written by an untrusted process: the geometry of the ring is copied when the
+ * view is created and the length of each message is checked against the size of the slots, so a
+ * corrupt ring cannot make this side access memory outside of it.
+ */
+class SharedRing {
+private:
+	/**
+	 * Layout of the ring in memory (followed by the slots). The indexes of each side are in their
+	 * own cache line
+	 */
+	struct Header {
+		/**
+		 * Next slot to consume (free running counter)
+		 */
+		alignas(64) std::atomic<uint32_t> head;
+		/**
+		 * The producer is sleeping because the ring is full
+		 */
+		std::atomic<uint32_t> producerSleeping;
+		/**
+		 * Next slot to produce (free running counter)
+		 */
+		alignas(64) std::atomic<uint32_t> tail;
+		/**
+		 * The consumer is sleeping because the ring is empty
+		 */
+		std::atomic<uint32_t> consumerSleeping;
+		/**
+		 * Number of slots (power of two)
+		 */
+		alignas(64) uint32_t capacity;
+		/**
+		 * Size of each slot, including the length of the message
+		 */
+		uint32_t slotSize;
+	};
+
+	/**
+	 * Header of the ring
+	 */
+	Header* header;
+	/**
+	 * First slot
+	 */
+	char* slots;
+	/**
+	 * Number of slots (copied from the header when the view is created)
+	 */
+	uint32_t capacity;
+	/**
+	 * Size of each slot (copied from the header when the view is created)
+	 */
+	uint32_t slotSize;
+
+	/**
+	 * Check the geometry of a ring
+	 * @param[in] capacity	Number of slots (power of two)
+	 * @param[in] slotSize	Size of each slot (multiple of 8)
+	 * @throw std::invalid_argument if the capacity or the slot size are not valid
+	 */
+	static void checkGeometry(const uint32_t capacity, const uint32_t slotSize) {
+		if ((capacity == 0) || ((capacity & (capacity - 1)) != 0) || (slotSize <= sizeof(uint32_t)) || (slotSize % 8 != 0))
+			throw std::invalid_argument("Invalid ring geometry");
+	};
+
+	/**
+	 * Obtain a slot
+	 */
+	char* slot(const uint32_t index) const {
+		return slots + static_cast<size_t>(index & (capacity - 1)) * slotSize;
+	};
+
+public:
+	/**
+	 * Obtain the memory needed by a ring
+	 * @param[in] capacity	Number of slots (power of two)
+	 * @param[in] slotSize	Size of each slot (the maximum message length is slotSize - 4)
+	 * @return				Size of the ring (in bytes), a multiple of the cache line
+	 */
+	static size_t size(const uint32_t capacity, const uint32_t slotSize) {
+		return (sizeof(Header) + static_cast<size_t>(capacity) * slotSize + 63) & ~static_cast<size_t>(63);
+	};
+
+	/**
+	 * Initialize a ring in a memory area
+	 * @param[in] memory	Memory area of, at least, size(capacity, slotSize) bytes, aligned to 64 bytes
+	 * @param[in] capacity	Number of slots (power of two)
+	 * @param[in] slotSize	Size of each slot (multiple of 8)
+	 * @throw std::invalid_argument if the capacity or the slot size are not valid
+	 */
+	static void initialize(void* memory, const uint32_t capacity, const uint32_t slotSize) {
+		checkGeometry(capacity, slotSize);
+		Header* header = new (memory) Header();
+		header->head.store(0, std::memory_order_relaxed);
+		header->producerSleeping.store(0, std::memory_order_relaxed);
+		header->tail.store(0, std::memory_order_relaxed);
+		header->consumerSleeping.store(0, std::memory_order_relaxed);
+		header->capacity = capacity;
+		header->slotSize = slotSize;
+	};
+
+	/**
+	 * Class constructor
+	 * @param[in] memory	Memory area of a ring initialized with this geometry
+	 * @param[in] capacity	Number of slots
+	 * @param[in] slotSize	Size of each slot
+	 * @throw std::invalid_argument if the capacity or the slot size are not valid
+	 */
+	SharedRing(void* memory, const uint32_t capacity, const uint32_t slotSize) : header(static_cast<Header*>(memory)),
+			slots(static_cast<char*>(memory) + sizeof(Header)), capacity(capacity), slotSize(slotSize) {
+		checkGeometry(capacity, slotSize);
+	};
+
+	/**
+	 * Class constructor. The geometry is read from the header of the ring
+	 * @param[in] memory	Memory area of an initialized ring
+	 * @throw std::invalid_argument if the geometry in the header is not valid
+	 */
+	explicit SharedRing(void* memory) : header(static_cast<Header*>(memory)),
+			slots(static_cast<char*>(memory) + sizeof(Header)), capacity(header->capacity), slotSize(header->slotSize) {
+		checkGeometry(capacity, slotSize);
+	};
+
+	/**
+	 * Obtain the number of slots
+	 */
+	uint32_t getCapacity() const {
+		return capacity;
+	};
+
+	/**
+	 * Obtain the size of the slots
+	 */
+	uint32_t getSlotSize() const {
+		return slotSize;
+	};
+
+	/**
+	 * Obtain the maximum length of a message
+	 */
+	size_t getMaxMessageSize() const {
+		return slotSize - sizeof(uint32_t);
+	};
+
+	/**
+	 * Put a message in the ring, if there is room (only from the producer)
+	 * @param[in] data		Message
+	 * @param[in] length	Length of the message
+	 * @return				False if the ring is full
+	 * @throw std::invalid_argument if the message does not fit in a slot
+	 */
+	bool tryPush(const char* data, const size_t length) {
+		if (length > getMaxMessageSize())
+			throw std::invalid_argument("The message does not fit in a slot of the ring");
+		const uint32_t tail = header->tail.load(std::memory_order_relaxed);
+		if (tail - header->head.load(std::memory_order_acquire) == capacity)
+			return false;
+		char* target = slot(tail);
+		const uint32_t size = static_cast<uint32_t>(length);
+		std::memcpy(target, &size, sizeof(size));
+		std::memcpy(target + sizeof(size), data, length);
+		// Publish the message. The store and the load are sequentially consistent, so either the
+		// consumer sees the new tail before sleeping, or this side sees that it is sleeping
+		header->tail.store(tail + 1, std::memory_order_seq_cst);
+		if (header->consumerSleeping.load(std::memory_order_seq_cst) != 0)
+			Futex::wake(header->tail);
+		return true;
+	};
+
+	/**
+	 * Put a message in the ring, waiting while it is full (only from the producer)
+	 * @param[in] data		Message
+	 * @param[in] length	Length of the message
+	 * @param[in] timeout	Maximum time to wait
+	 * @return				False if the ring is still full after the timeout
+	 */
+	bool push(const char* data, const size_t length, const std::chrono::nanoseconds& timeout) {
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+		while (!tryPush(data, length)) {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (now >= deadline)
+				return false;
+			const uint32_t head = header->head.load(std::memory_order_relaxed);
+			header->producerSleeping.store(1, std::memory_order_seq_cst);
+			if (header->tail.load(std::memory_order_relaxed) - header->head.load(std::memory_order_seq_cst) == capacity)
+				Futex::wait(header->head, head, deadline - now);
+			header->producerSleeping.store(0, std::memory_order_relaxed);
+		}
+		return true;
+	};
+
+	/**
+	 * Take the next message from the ring, if any (only from the consumer)
+	 * @param[out] message	Message. It is empty if its length does not fit in a slot (corrupt ring)
+	 * @return				False if the ring is empty
+	 */
+	bool tryPop(std::string& message) {
+		const uint32_t head = header->head.load(std::memory_order_relaxed);
+		if (head == header->tail.load(std::memory_order_acquire))
+			return false;
+		const char* source = slot(head);
+		uint32_t size;
+		std::memcpy(&size, source, sizeof(size));
+		if (size <= getMaxMessageSize())
+			message.assign(source + sizeof(size), size);
+		else
+			message.clear();
+		// Release the slot
+		header->head.store(head + 1, std::memory_order_seq_cst);
+		if (header->producerSleeping.load(std::memory_order_seq_cst) != 0)
+			Futex::wake(header->head);
+		return true;
+	};
+
+	/**
+	 * Take the next message from the ring, waiting while it is empty (only from the consumer)
+	 * @param[out] message	Message
+	 * @param[in] timeout	Maximum time to wait
+	 * @return				False if the ring is still empty after the timeout
+	 */
+	bool pop(std::string& message, const std::chrono::nanoseconds& timeout) {
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+		while (!tryPop(message)) {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (now >= deadline)
+				return false;
+			const uint32_t tail = header->tail.load(std::memory_order_relaxed);
+			header->consumerSleeping.store(1, std::memory_order_seq_cst);
+			if (header->head.load(std::memory_order_relaxed) == header->tail.load(std::memory_order_seq_cst))
+				Futex::wait(header->tail, tail, deadline - now);
+			header->consumerSleeping.store(0, std::memory_order_relaxed);
+		}
+		return true;
+	};
+
+	/**
+	 * Wake up the consumer, if it is sleeping (e.g. to make it check whether it has to finish)
+	 */
+	void wakeConsumer() {
+		Futex::wake(header->tail);
+	};
+};
+
+} /* namespace ipc */
+} /* namespace proactor */
+
+#endif /* IPC_SHAREDRING_HPP_ */
@@ -0,0 +1,168 @@
+/**
+ * @file IpcDemo.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Two processes which exchange operations through a shared memory channel: the server executes the
+ * operations submitted by the client and sends back their completions. The client checks the
+ * results, measures the round trip of a single operation and the throughput with many operations
+ * in flight.
+ * Usage:
+ *   IpcDemo [N]					Fork a client process which submits N operations (default: 100000)
+ *   IpcDemo server NAME SECONDS	Serve the channel NAME during SECONDS
+ *   IpcDemo client NAME [N]		Submit N operations to the channel NAME
+ * @see ipc/SharedMemoryServer
+ * @see ipc/SharedMemoryClient
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../asyncOperation/SumAsynchronousOperation.hpp"
+#include "../asyncOperation/SyntheticAsynchronousOperation.hpp"
+#include "../exception/IOException.hpp"
+#include "../ipc/SharedMemoryClient.hpp"
+#include "../ipc/SharedMemoryServer.hpp"
+#include "../logger/Logger.hpp"
+#include "../registry/OperationRegistry.hpp"
+
+using namespace proactor;
+
+/**
+ * Operation submitted by the client: it does not spend any time, so the measures are the cost of
+ * the channel and the engine
+ */
+const std::string OPERATION = "const:0 spin";
+
+/**
+ * Window of operations in flight in the throughput test
+ */
+const size_t WINDOW = 256;
+
+/**
+ * Attach to a channel, waiting for the server to create it
+ */
+ipc::SharedMemoryClient* attach(const std::string& name) {
+	for (int attempt = 0; ; ++attempt) {
+		try {
+			return new ipc::SharedMemoryClient(name);
+		} catch (exception::IOException& e) {
+			if (attempt == 100)
+				throw;
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+	}
+}
+
+/**
+ * Client process
+ * @param[in] name			Name of the channel
+ * @param[in] operations	Number of operations of each test
+ * @return					Exit code
+ */
+int runClient(const std::string& name, const size_t operations) {
+	std::unique_ptr<ipc::SharedMemoryClient> client;
+	try {
+		client.reset(attach(name));
+	} catch (exception::IOException& e) {
+		std::cerr << e.getMessage() << std::endl;
+		return EXIT_FAILURE;
+	}
+	ipc::Completion completion;
+
+	// Results and errors
+	client->submit(ipc::Submission{1, "synthetic", "const:5 spin"});
+	client->submit(ipc::Submission{2, "unknown", ""});
+	for (int i = 0; i < 2; ++i) {
+		if (!client->complete(completion, std::chrono::seconds(5))) {
+			std::cerr << "No completion received" << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << "Completion " << completion.userData << ": " << (completion.succeeded ? "result " : "error: ")
+				  << completion.result << std::endl;
+	}
+
+	// Round trip of one operation at a time
+	std::vector<double> latencies;
+	latencies.reserve(operations);
+	for (size_t i = 0; i < operations; ++i) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		client->submit(ipc::Submission{i, "synthetic", OPERATION});
+		if (!client->complete(completion, std::chrono::seconds(5)) || (completion.userData != i)) {
+			std::cerr << "Completion " << i << " not received" << std::endl;
+			return EXIT_FAILURE;
+		}
+		latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+	}
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << std::fixed << std::setprecision(1) << "Round trip (us):  p50 " << latencies[latencies.size() / 2]
+			  << "  p99 " << latencies[latencies.size() * 99 / 100] << "  max " << latencies.back() << std::endl;
+
+	// Throughput with many operations in flight
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	size_t submitted = 0, completed = 0;
+	while (completed < operations) {
+		while ((submitted < operations) && (submitted - completed < WINDOW))
+			client->submit(ipc::Submission{submitted++, "synthetic", OPERATION});
+		if (!client->complete(completion, std::chrono::seconds(5))) {
+			std::cerr << "Completions not received" << std::endl;
+			return EXIT_FAILURE;
+		}
+		++completed;
+		while (client->tryComplete(completion))
+			++completed;
+	}
+	const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Throughput:       " << operations / elapsed << " ops/s (" << WINDOW << " in flight)" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Create the server of a channel
+ */
+ipc::SharedMemoryServer<long long>* createServer(const std::string& name, const registry::OperationRegistry<long long>& registry) {
+	return new ipc::SharedMemoryServer<long long>(name, registry, ipc::SharedMemoryServer<long long>::DEFAULT_CAPACITY,
+			ipc::SharedMemoryServer<long long>::DEFAULT_SLOT_SIZE, 4);
+}
+
+int main(int argc, char *argv[]) {
+	logger::Logger::setEnabled(false);
+	registry::OperationRegistry<long long> registry;
+	registry.registerType<asyncOperation::SyntheticAsynchronousOperation<long long> >();
+	registry.registerType<asyncOperation::SumAsynchronousOperation<long long> >();
+
+	const std::string mode = (argc > 1) ? argv[1] : "";
+	if ((mode == "server") && (argc == 4)) {
+		std::unique_ptr<ipc::SharedMemoryServer<long long> > server(createServer(argv[2], registry));
+		std::this_thread::sleep_for(std::chrono::duration<double>(std::stod(argv[3])));
+		return EXIT_SUCCESS;
+	}
+	if ((mode == "client") && (argc >= 3))
+		return runClient(argv[2], (argc > 3) ? std::stoul(argv[3]) : 100000);
+	if (argc > 2) {
+		std::cerr << "Usage: " << argv[0] << " [N] | server NAME SECONDS | client NAME [N]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Fork the client before any thread is started
+	const std::string name = "/proactor-demo-" + utils::Utils::tostr(getpid());
+	const size_t operations = (argc > 1) ? std::stoul(argv[1]) : 100000;
+	const pid_t pid = fork();
+	if (pid == 0)
+		return runClient(name, operations);
+
+	int status = EXIT_FAILURE;
+	{
+		std::unique_ptr<ipc::SharedMemoryServer<long long> > server(createServer(name, registry));
+		waitpid(pid, &status, 0);
+	}
+	return (WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,505 @@
+/**
+ * @file CompletionJournal.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Append-only journal of the submitted and completed operations, so that the operations which
+ * were not completed can be replayed after a crash.
+ */
+
+#ifndef JOURNAL_COMPLETIONJOURNAL_HPP_
+#define JOURNAL_COMPLETIONJOURNAL_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../exception/IOException.hpp"
+#include "../logger/Logger.hpp"
+
+namespace proactor {
+namespace journal {
+
+/**
+ * This class implements a journal of operations with group commit: the records are appended to
+ * a buffer and a writer thread writes and synchronizes (fdatasync) them in batches, when the batch
+ * reaches a size or when its oldest record reaches an age. Many records (from many threads) are
+ * therefore made durable with a single write and synchronization.
+ * When the journal is opened, the submissions of the previous runs which were not completed are
+ * loaded (see getUnfinished) and the file is compacted to contain only them.
+ * Only the operations with a registered type (AsynchronousOperation::getTypeName) are journaled.
+ * The replay gives at-least-once semantics: an operation whose completion was dispatched but not
+ * journaled before the crash is replayed.
+ * @see initiatorCompletion/InitiatorCompletion
+ */
+class CompletionJournal {
+public:
+	/**
+	 * Submission read from the journal
+	 */
+	struct Entry {
+		/**
+		 * Run of the journal in which the operation was submitted
+		 */
+		uint64_t run;
+		/**
+		 * Identifier of the operation in its run
+		 */
+		uint64_t operationId;
+		/**
+		 * Name of the type of the operation
+		 */
+		std::string typeName;
+		/**
+		 * Serialized arguments of the operation
+		 */
+		std::string arguments;
+	};
+
+	/**
+	 * Counters of the journal
+	 */
+	struct Statistics {
+		/**
+		 * Appended records
+		 */
+		uint64_t records;
+		/**
+		 * Written batches (each one with a single write and fdatasync)
+		 */
+		uint64_t batches;
+		/**
+		 * Written bytes
+		 */
+		uint64_t bytes;
+	};
+
+	/**
+	 * Default maximum size of a batch (in bytes)
+	 */
+	static const size_t DEFAULT_BATCH_SIZE = 64 << 10;
+	/**
+	 * Default maximum age of the oldest record of a batch (in microseconds)
+	 */
+	static const unsigned int DEFAULT_BATCH_DELAY = 1000;
+
+private:
+	/**
+	 * Types of record
+	 */
+	enum RecordType : uint8_t {
+		SUBMISSION = 1,
+		COMPLETION = 2
+	};
+
+	/**
+	 * Size of the record header (payload length and checksum)
+	 */
+	static const size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+
+	/**
+	 * Path of the journal
+	 */
+	const std::string path;
+	/**
+	 * Maximum size of a batch
+	 */
+	const size_t maxBatchSize;
+	/**
+	 * Maximum age of the oldest record of a batch
+	 */
+	const std::chrono::microseconds maxBatchDelay;
+	/**
+	 * Identifier of this run of the journal (operation identifiers are only unique in a run)
+	 */
+	const uint64_t run;
+	/**
+	 * Submissions of the previous runs which were not completed
+	 */
+	std::vector<Entry> unfinished;
+	/**
+	 * Descriptor of the journal
+	 */
+	int fd;
+	/**
+	 * Lock of the buffer and the counters
+	 */
+	std::mutex mutex;
+	/**
+	 * Condition variable used to wake up the writer
+	 */
+	std::condition_variable writerCv;
+	/**
+	 * Condition variable used to wake up the threads waiting for their records to be durable
+	 */
+	std::condition_variable durableCv;
+	/**
+	 * Records which have not been written yet
+	 */
+	std::string buffer;
+	/**
+	 * Time when the oldest record in the buffer was appended
+	 */
+	std::chrono::steady_clock::time_point oldest;
+	/**
+	 * Sequence number of the last appended record
+	 */
+	uint64_t appended;
+	/**
+	 * Sequence number of the last durable record
+	 */
+	uint64_t durable;
+	/**
+	 * Indicates that the writer has to finish (once the buffer is written)
+	 */
+	bool stop;
+	/**
+	 * Indicates that a write or a synchronization has failed
+	 */
+	bool failed;
+	/**
+	 * Counters of the journal
+	 */
+	Statistics statistics;
+	/**
+	 * Thread which writes the batches
+	 */
+	std::thread writer;
+
+	/**
+	 * Compute the checksum of a payload (FNV-1a)
+	 */
+	static uint32_t checksum(const char* data, const size_t size) {
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= static_cast<unsigned char>(data[i]);
+			hash *= 16777619u;
+		}
+		return hash;
+	};
+
+	/**
+	 * Append a value to a record
+	 */
+	template <typename Value>
+	static void put(std::string& record, const Value value) {
+		record.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+
+	/**
+	 * Read a value from a record
+	 * @return	False if the record is too short
+	 */
+	template <typename Value>
+	static bool get(const std::string& data, size_t& position, const size_t end, Value& value) {
+		if (end - position < sizeof(value))
+			return false;
+		std::memcpy(&value, data.data() + position, sizeof(value));
+		position += sizeof(value);
+		return true;
+	};
+
+	/**
+	 * Encode a record (header and payload) at the end of a buffer
+	 */
+	static void encode(std::string& output, const RecordType type, const uint64_t run, const uint64_t operationId,
+					   const std::string& typeName, const std::string& arguments) {
+		const size_t start = output.size();
+		output.append(HEADER_SIZE, '\0');
+		put(output, static_cast<uint8_t>(type));
+		put(output, run);
+		put(output, operationId);
+		put(output, static_cast<uint32_t>(typeName.size()));
+		output.append(typeName);
+		put(output, static_cast<uint32_t>(arguments.size()));
+		output.append(arguments);
+
+		const uint32_t length = static_cast<uint32_t>(output.size() - start - HEADER_SIZE);
+		const uint32_t sum = checksum(output.data() + start + HEADER_SIZE, length);
+		std::memcpy(&output[start], &length, sizeof(length));
+		std::memcpy(&output[start + sizeof(length)], &sum, sizeof(sum));
+	};
+
+	/**
+	 * Write a whole buffer in a file
+	 */
+	static bool writeAll(const int fd, const std::string& data) {
+		size_t written = 0;
+		while (written < data.size()) {
+			const ssize_t bytes = ::write(fd, data.data() + written, data.size() - written);
+			if ((bytes < 0) && (errno == EINTR))
+				continue;
+			if (bytes <= 0)
+				return false;
+			written += bytes;
+		}
+		return true;
+	};
+
+	/**
+	 * Identify this run of the journal
+	 */
+	static uint64_t newRun() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count());
+	};
+
+	/**
+	 * Rewrite the journal with only the unfinished submissions. The new journal is written in a
+	 * temporary file which replaces the journal atomically
+	 */
+	void compact() {
+		std::string data;
+		for (const Entry& entry : unfinished)
+			encode(data, SUBMISSION, entry.run, entry.operationId, entry.typeName, entry.arguments);
+
+		const std::string temporary = path + ".tmp";
+		const int tmp = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (tmp < 0)
+			throw exception::IOException("Cannot create " + temporary + ": " + std::strerror(errno));
+		const bool written = writeAll(tmp, data) && (fdatasync(tmp) == 0);
+		close(tmp);
+		if (!written || (rename(temporary.c_str(), path.c_str()) != 0))
+			throw exception::IOException("Cannot compact " + path + ": " + std::strerror(errno));
+
+		// Make the rename durable
+		const size_t separator = path.find_last_of('/');
+		const std::string directory = (separator == std::string::npos) ? "." : path.substr(0, separator + 1);
+		const int dirFd = open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+		if (dirFd >= 0) {
+			fsync(dirFd);
+			close(dirFd);
+		}
+	};
+
+	/**
+	 * Append a record to the buffer
+	 * @return	Sequence number of the record
+	 */
+	uint64_t append(const RecordType type, const uint64_t run, const uint64_t operationId,
+					const std::string& typeName, const std::string& arguments) {
+		std::lock_guard<std::mutex> locker(mutex);
+		const bool wasEmpty = buffer.empty();
+		if (wasEmpty)
+			oldest = std::chrono::steady_clock::now();
+		encode(buffer, type, run, operationId, typeName, arguments);
+		++statistics.records;
+		// Wake up the writer to start the delay of a new batch, or to write a full batch
+		if (wasEmpty || (buffer.size() >= maxBatchSize))
+			writerCv.notify_one();
+		return ++appended;
+	};
+
+	/**
+	 * Main loop of the writer thread
+	 */
+	void writeBatches() {
+		std::string batch;
+		std::unique_lock<std::mutex> locker(mutex);
+		while (true) {
+			if (buffer.empty()) {
+				if (stop)
+					return;
+				writerCv.wait(locker, [&]{ return stop || !buffer.empty();});
+				continue;
+			}
+			// Wait until the batch is full or its oldest record is too old (or the journal is closed)
+			writerCv.wait_until(locker, oldest + maxBatchDelay, [&]{ return stop || buffer.size() >= maxBatchSize;});
+
+			batch.swap(buffer);
+			const uint64_t sequence = appended;
+			locker.unlock();
+			const bool written = writeAll(fd, batch) && (fdatasync(fd) == 0);
+			if (!written)
+				logger::Logger::log("Cannot write the journal " + path + ": " + std::strerror(errno));
+			locker.lock();
+
+			failed = failed || !written;
+			durable = sequence;
+			++statistics.batches;
+			statistics.bytes += batch.size();
+			batch.clear();
+			durableCv.notify_all();
+		}
+	};
+
+public:
+	/**
+	 * Class constructor. It loads the unfinished submissions of the journal (if it exists), compacts
+	 * it and starts the writer thread
+	 * @param[in] path			Path of the journal
+	 * @param[in] maxBatchSize	A batch is written when it reaches this size (in bytes)
+	 * @param[in] maxBatchDelay	A batch is written when its oldest record reaches this age
+	 * @throw exception::IOException if the journal cannot be opened
+	 */
+	CompletionJournal(const std::string& path,
+					  const size_t maxBatchSize = DEFAULT_BATCH_SIZE,
+					  const std::chrono::microseconds& maxBatchDelay = std::chrono::microseconds(DEFAULT_BATCH_DELAY)) :
+						  path(path),
+						  maxBatchSize(maxBatchSize),
+						  maxBatchDelay(maxBatchDelay),
+						  run(newRun()),
+						  unfinished(readUnfinished(path)),
+						  fd(-1),
+						  appended(0),
+						  durable(0),
+						  stop(false),
+						  failed(false),
+						  statistics() {
+		compact();
+		fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+		if (fd < 0)
+			throw exception::IOException("Cannot open " + path + ": " + std::strerror(errno));
+		writer = std::thread(&CompletionJournal::writeBatches, this);
+	};
+
+	/**
+	 * Class destructor. It writes the remaining records
+	 */
+	virtual ~CompletionJournal() {
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			stop = true;
+		}
+		writerCv.notify_one();
+		writer.join();
+		close(fd);
+	};
+
+	/**
+	 * Read the submissions of a journal which were not completed
+	 * @param[in] path	Path of the journal
+	 * @return			Unfinished submissions, in submission order. The records after the first
+	 * 					truncated or corrupted one (torn write) are ignored
+	 */
+	static std::vector<Entry> readUnfinished(const std::string& path) {
+		std::string data;
+		const int input = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (input >= 0) {
+			char block[1 << 16];
+			ssize_t bytes;
+			while ((bytes = ::read(input, block, sizeof(block))) != 0) {
+				if (bytes > 0)
+					data.append(block, bytes);
+				else if (errno != EINTR)
+					break;
+			}
+			close(input);
+		}
+
+		std::vector<Entry> entries;
+		std::vector<bool> completed;
+		std::map<std::pair<uint64_t, uint64_t>, size_t> index;
+		size_t position = 0;
+		while (data.size() - position >= HEADER_SIZE) {
+			uint32_t length, sum;
+			get(data, position, data.size(), length);
+			get(data, position, data.size(), sum);
+			if ((data.size() - position < length) || (checksum(data.data() + position, length) != sum))
+				break;
+			const size_t end = position + length;
+
+			uint8_t type;
+			uint32_t size;
+			Entry entry;
+			if (!get(data, position, end, type) || !get(data, position, end, entry.run) ||
+					!get(data, position, end, entry.operationId) || !get(data, position, end, size) || (end - position < size))
+				break;
+			entry.typeName.assign(data, position, size);
+			position += size;
+			if (!get(data, position, end, size) || (end - position < size))
+				break;
+			entry.arguments.assign(data, position, size);
+			position = end;
+
+			const std::pair<uint64_t, uint64_t> key(entry.run, entry.operationId);
+			if (type == SUBMISSION) {
+				index[key] = entries.size();
+				entries.push_back(entry);
+				completed.push_back(false);
+			} else if (index.find(key) != index.end()) {
+				completed[index[key]] = true;
+			}
+		}
+
+		std::vector<Entry> result;
+		for (size_t i = 0; i < entries.size(); ++i)
+			if (!completed[i])
+				result.push_back(entries[i]);
+		return result;
+	};
+
+	/**
+	 * Obtain the submissions of the previous runs which were not completed
+	 */
+	const std::vector<Entry>& getUnfinished() const {
+		return unfinished;
+	};
+
+	/**
+	 * Record the submission of an operation
+	 * @param[in] operationId	Identifier of the operation
+	 * @param[in] typeName		Name of the type of the operation
+	 * @param[in] arguments		Serialized arguments of the operation
+	 * @return					Sequence number of the record (see waitDurable)
+	 */
+	uint64_t appendSubmission(const uint64_t operationId, const std::string& typeName, const std::string& arguments) {
+		return append(SUBMISSION, run, operationId, typeName, arguments);
+	};
+
+	/**
+	 * Record the completion of an operation
+	 * @param[in] operationId	Identifier of the operation
+	 * @return					Sequence number of the record (see waitDurable)
+	 */
+	uint64_t appendCompletion(const uint64_t operationId) {
+		return append(COMPLETION, run, operationId, std::string(), std::string());
+	};
+
+	/**
+	 * Record the replay of an unfinished submission of a previous run: the operation is recorded as
+	 * a new submission and the previous one as completed
+	 * @param[in] entry			Unfinished submission
+	 * @param[in] operationId	Identifier of the replayed operation
+	 * @return					Sequence number of the last record (see waitDurable)
+	 */
+	uint64_t appendReplay(const Entry& entry, const uint64_t operationId) {
+		appendSubmission(operationId, entry.typeName, entry.arguments);
+		return append(COMPLETION, entry.run, entry.operationId, std::string(), std::string());
+	};
+
+	/**
+	 * Wait until a record (and all the previous ones) has been written and synchronized
+	 * @param[in] sequence	Sequence number of the record
+	 * @throw exception::IOException if the journal could not be written
+	 */
+	void waitDurable(const uint64_t sequence) {
+		std::unique_lock<std::mutex> locker(mutex);
+		durableCv.wait(locker, [&]{ return durable >= sequence;});
+		if (failed)
+			throw exception::IOException("Cannot write the journal " + path);
+	};
+
+	/**
+	 * Obtain the counters of the journal
+	 */
+	Statistics getStatistics() {
+		std::lock_guard<std::mutex> locker(mutex);
+		return statistics;
+	};
+};
+
+} /* namespace journal */
+} /* namespace proactor */
+
+#endif /* JOURNAL_COMPLETIONJOURNAL_HPP_ */
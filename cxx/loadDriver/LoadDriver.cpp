@@ -0,0 +1,378 @@
+/**
+ * @file LoadDriver.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Open-loop load driver: it submits synthetic operations at a given rate, regardless of how fast
+ * they are completed, and reports the throughput and the latency percentiles.
+ * The latency is measured from the time at which each operation was scheduled to be submitted
+ * (corrected for coordinated omission: if the submissions are delayed because the system is
+ * saturated, the delay is part of the latency) and also from its actual submission.
+ * Usage: LoadDriver [options]
+ *   --rate OPS				Submitted operations per second (default: 1000)
+ *   --arrival poisson|fixed	Arrival process (default: poisson)
+ *   --duration SECONDS		Duration of the test (default: 10)
+ *   --service SPEC			Service time distribution, in microseconds (default: exp:500):
+ *   						const:MEAN, exp:MEAN, bimodal:FAST:SLOW:SLOW_PROBABILITY, pareto:MEAN:SHAPE
+ *   --mode spin|sleep		How the operations spend their service time (default: sleep)
+ *   --workers N				Pool size of the processor (default: 4)
+ *   --adaptive MIN:MAX		Adapt the pool size with the AIMD controller instead
+ *   --inline				Complete the operations inline in the workers
+ *   --seed N				Seed of the arrival process (default: random)
+ *   --journal PATH			Record the operations in a journal (replayed in the next run)
+ *   --journal-delay US		Maximum delay of a group commit of the journal (default: 1000)
+ *   --journal-async			Do not wait for the submissions to be durable
+ *   --watchdog MS			Report the operations and dispatches which take longer than MS milliseconds
+ * @see asyncOperation/SyntheticAsynchronousOperation
+ * @see initiatorCompletion/InitiatorCompletion
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../asyncOperation/SyntheticAsynchronousOperation.hpp"
+#include "../concurrencyController/AimdConcurrencyController.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../journal/CompletionJournal.hpp"
+#include "../logger/Logger.hpp"
+#include "../observer/Observer.hpp"
+#include "../registry/OperationRegistry.hpp"
+#include "../utils/ServiceTimeDistribution.hpp"
+#include "../watchdog/Watchdog.hpp"
+
+using namespace proactor;
+
+/**
+ * Synthetic operation which keeps the timestamps needed to compute its latency
+ */
+class DriverOperation : public asyncOperation::SyntheticAsynchronousOperation<long long> {
+public:
+	/**
+	 * Time at which the operation was scheduled to be submitted
+	 */
+	std::chrono::steady_clock::time_point intended;
+	/**
+	 * Time at which the operation was actually submitted
+	 */
+	std::chrono::steady_clock::time_point submitted;
+	/**
+	 * Time at which the completion was dispatched
+	 */
+	std::chrono::steady_clock::time_point completed;
+	/**
+	 * Indicates whether the operation has been replayed from the journal (it is not part of the test)
+	 */
+	bool replayed;
+
+	/**
+	 * Constructor
+	 * @param[in] distribution	Distribution of the service time
+	 * @param[in] mode			How the service time is spent
+	 */
+	DriverOperation(const utils::ServiceTimeDistribution& distribution, const asyncOperation::ServiceMode mode) :
+		asyncOperation::SyntheticAsynchronousOperation<long long>(distribution, mode), replayed(false) {
+	};
+
+	/**
+	 * Create an operation from its serialized arguments, to be replayed from the journal (the replayed
+	 * operations are completed through the same handler, which expects driver operations)
+	 * @param[in] arguments	Serialized arguments
+	 * @return				New operation (the caller takes the ownership)
+	 * @throw std::invalid_argument if the arguments are not valid
+	 */
+	static DriverOperation* deserialize(const std::string& arguments) {
+		const std::unique_ptr<asyncOperation::SyntheticAsynchronousOperation<long long> > parsed(
+				asyncOperation::SyntheticAsynchronousOperation<long long>::deserialize(arguments));
+		DriverOperation* operation = new DriverOperation(parsed->getDistribution(), parsed->getServiceMode());
+		operation->replayed = true;
+		return operation;
+	};
+};
+
+/**
+ * Handler which records the completion time of the operations
+ */
+class CompletionRecorder : public observer::Observer<asyncOperation::AsynchronousOperation<long long> > {
+public:
+	/**
+	 * Number of completed operations of the test
+	 */
+	std::atomic<size_t> completedOperations;
+	/**
+	 * Number of completed operations replayed from the journal
+	 */
+	std::atomic<size_t> replayedOperations;
+
+	/**
+	 * Class constructor
+	 */
+	CompletionRecorder() : completedOperations(0), replayedOperations(0) {
+	};
+
+	/**
+	 * Record the completion of an operation (it may be called concurrently with inline completions)
+	 * @param[in] operation	Completed operation
+	 */
+	void notify(asyncOperation::AsynchronousOperation<long long>* operation) {
+		DriverOperation* driverOperation = static_cast<DriverOperation*>(operation);
+		driverOperation->completed = std::chrono::steady_clock::now();
+		if (driverOperation->replayed)
+			replayedOperations.fetch_add(1, std::memory_order_relaxed);
+		else
+			completedOperations.fetch_add(1, std::memory_order_relaxed);
+	};
+};
+
+/**
+ * Configuration of the test
+ */
+struct Configuration {
+	/**
+	 * Submitted operations per second
+	 */
+	double rate = 1000;
+	/**
+	 * Poisson arrivals (or fixed rate otherwise)
+	 */
+	bool poisson = true;
+	/**
+	 * Duration of the test (in seconds)
+	 */
+	double duration = 10;
+	/**
+	 * Specification of the service time distribution
+	 */
+	std::string service = "exp:500";
+	/**
+	 * How the operations spend their service time
+	 */
+	asyncOperation::ServiceMode mode = asyncOperation::ServiceMode::SLEEP;
+	/**
+	 * Pool size of the processor
+	 */
+	size_t workers = 4;
+	/**
+	 * Limits of the adaptive concurrency controller (not used if the maximum is 0)
+	 */
+	size_t minLimit = 0;
+	size_t maxLimit = 0;
+	/**
+	 * Complete the operations inline in the workers
+	 */
+	bool inlineCompletion = false;
+	/**
+	 * Seed of the arrival process
+	 */
+	unsigned long long seed = std::random_device{}();
+	/**
+	 * Path of the journal (no journal if it is empty)
+	 */
+	std::string journal;
+	/**
+	 * Maximum delay of a group commit of the journal (in microseconds)
+	 */
+	unsigned int journalDelay = journal::CompletionJournal::DEFAULT_BATCH_DELAY;
+	/**
+	 * Wait for the submissions to be durable
+	 */
+	bool durableSubmissions = true;
+	/**
+	 * Threshold of the watchdog, in milliseconds (no watchdog if it is 0)
+	 */
+	unsigned int watchdogThreshold = 0;
+};
+
+/**
+ * Parse the command line
+ * @param[in] argc	Number of arguments
+ * @param[in] argv	Arguments
+ * @return			Configuration of the test
+ * @throw std::invalid_argument if an option is not valid
+ */
+Configuration parseArguments(int argc, char *argv[]) {
+	Configuration configuration;
+	for (int i = 1; i < argc; ++i) {
+		const std::string option = argv[i];
+		if (option == "--inline") {
+			configuration.inlineCompletion = true;
+			continue;
+		}
+		if (option == "--journal-async") {
+			configuration.durableSubmissions = false;
+			continue;
+		}
+		if (i + 1 == argc)
+			throw std::invalid_argument("Missing value of " + option);
+		const std::string value = argv[++i];
+		if (option == "--rate")
+			configuration.rate = std::stod(value);
+		else if (option == "--arrival" && (value == "poisson" || value == "fixed"))
+			configuration.poisson = (value == "poisson");
+		else if (option == "--duration")
+			configuration.duration = std::stod(value);
+		else if (option == "--service")
+			configuration.service = value;
+		else if (option == "--mode" && (value == "spin" || value == "sleep"))
+			configuration.mode = (value == "spin") ? asyncOperation::ServiceMode::SPIN : asyncOperation::ServiceMode::SLEEP;
+		else if (option == "--workers")
+			configuration.workers = std::stoul(value);
+		else if (option == "--adaptive" && value.find(':') != std::string::npos) {
+			configuration.minLimit = std::stoul(value.substr(0, value.find(':')));
+			configuration.maxLimit = std::stoul(value.substr(value.find(':') + 1));
+		} else if (option == "--seed")
+			configuration.seed = std::stoull(value);
+		else if (option == "--journal")
+			configuration.journal = value;
+		else if (option == "--journal-delay")
+			configuration.journalDelay = std::stoul(value);
+		else if (option == "--watchdog")
+			configuration.watchdogThreshold = std::stoul(value);
+		else
+			throw std::invalid_argument("Invalid option: " + option + " " + value);
+	}
+	if ((configuration.rate <= 0) || (configuration.duration <= 0) || (configuration.workers == 0))
+		throw std::invalid_argument("The rate, the duration and the workers must be positive");
+	return configuration;
+}
+
+/**
+ * Display the percentiles of a set of latencies
+ * @param[in] name		Name of the set
+ * @param[in] latencies	Latencies (in microseconds). They are sorted by this function
+ */
+void showPercentiles(const std::string& name, std::vector<double>& latencies) {
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(1);
+	const double percentiles[] = {0.5, 0.9, 0.99, 0.999, 1.0};
+	for (double percentile : percentiles) {
+		const size_t rank = static_cast<size_t>(std::ceil(percentile * latencies.size()));
+		std::cout << std::setw(12) << (latencies.empty() ? 0.0 : latencies[std::max<size_t>(rank, 1) - 1]);
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	Configuration configuration;
+	utils::ServiceTimeDistribution distribution(utils::ServiceTimeDistribution::Type::CONSTANT, 0);
+	try {
+		configuration = parseArguments(argc, argv);
+		distribution = utils::ServiceTimeDistribution::parse(configuration.service);
+	} catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	logger::Logger::setEnabled(false);
+
+	// Create the operations beforehand, so that the submission loop does not allocate
+	const size_t expected = static_cast<size_t>(configuration.rate * configuration.duration);
+	const size_t capacity = configuration.poisson ? expected + 10 * static_cast<size_t>(std::sqrt(expected)) + 10 : expected;
+	std::vector<std::unique_ptr<DriverOperation> > operations;
+	operations.reserve(capacity);
+	for (size_t i = 0; i < capacity; ++i)
+		operations.push_back(std::unique_ptr<DriverOperation>(new DriverOperation(distribution, configuration.mode)));
+
+	CompletionRecorder recorder;
+	std::shared_ptr<concurrencyController::ConcurrencyController> controller;
+	if (configuration.maxLimit > 0)
+		controller = std::make_shared<concurrencyController::AimdConcurrencyController>(configuration.minLimit, configuration.maxLimit);
+	// The stalls are printed as they are detected
+	std::shared_ptr<watchdog::Watchdog> stallWatchdog;
+	if (configuration.watchdogThreshold > 0)
+		stallWatchdog = std::make_shared<watchdog::Watchdog>(std::chrono::milliseconds(configuration.watchdogThreshold),
+				std::chrono::milliseconds(configuration.watchdogThreshold), [](const watchdog::StallReport& report) {
+			std::cerr << (report.kind == watchdog::StallKind::OPERATION ? "Stalled operation " : "Stalled dispatch of operation ")
+					  << report.operationId << " in " << report.threadName << " thread " << report.threadId << " for "
+					  << std::chrono::duration_cast<std::chrono::milliseconds>(report.elapsed).count() << " ms" << std::endl;
+		});
+	initiatorCompletion::InitiatorCompletion<long long> initiator(&recorder,
+			configuration.inlineCompletion ? asyncOperation::CompletionMode::INLINE : asyncOperation::CompletionMode::SERIALIZED,
+			configuration.workers, controller, stallWatchdog);
+	std::shared_ptr<journal::CompletionJournal> completionJournal;
+	if (!configuration.journal.empty()) {
+		try {
+			completionJournal = std::make_shared<journal::CompletionJournal>(configuration.journal,
+					journal::CompletionJournal::DEFAULT_BATCH_SIZE, std::chrono::microseconds(configuration.journalDelay));
+		} catch (std::exception& e) {
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		initiator.setJournal(completionJournal, configuration.durableSubmissions);
+		// The operations left by an interrupted run are replayed before the test (and not measured)
+		registry::OperationRegistry<long long> registry;
+		registry.registerType<DriverOperation>();
+		const size_t replayed = initiator.recover(registry).size();
+		if (replayed > 0)
+			std::cout << "Replayed " << replayed << " unfinished operations of the journal" << std::endl;
+	}
+
+	// Open loop: the schedule does not depend on the completions
+	std::mt19937_64 generator(configuration.seed);
+	std::exponential_distribution<double> interarrival(configuration.rate);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	size_t submitted = 0;
+	double offset = 0;
+	while (submitted < capacity) {
+		offset += configuration.poisson ? interarrival(generator) : 1.0 / configuration.rate;
+		if (offset >= configuration.duration)
+			break;
+		DriverOperation* operation = operations[submitted].get();
+		operation->intended = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(offset));
+		std::this_thread::sleep_until(operation->intended);
+		operation->submitted = std::chrono::steady_clock::now();
+		initiator.processOperation(operation);
+		++submitted;
+	}
+	const std::chrono::steady_clock::time_point lastSubmission = std::chrono::steady_clock::now();
+	const size_t finalLimit = initiator.getConcurrencyLimit();
+	initiator.shutdown(initiatorCompletion::ShutdownMode::GRACEFUL);
+
+	// Results
+	std::vector<double> corrected, uncorrected;
+	corrected.reserve(submitted);
+	uncorrected.reserve(submitted);
+	std::chrono::steady_clock::time_point lastCompletion = start;
+	for (size_t i = 0; i < submitted; ++i) {
+		const DriverOperation& operation = *operations[i];
+		corrected.push_back(std::chrono::duration<double, std::micro>(operation.completed - operation.intended).count());
+		uncorrected.push_back(std::chrono::duration<double, std::micro>(operation.completed - operation.submitted).count());
+		lastCompletion = std::max(lastCompletion, operation.completed);
+	}
+	const double elapsed = std::chrono::duration<double>(lastCompletion - start).count();
+	const double submissionTime = std::chrono::duration<double>(lastSubmission - start).count();
+
+	std::cout << std::fixed << std::setprecision(1)
+			  << "Offered rate:      " << configuration.rate << " ops/s (" << (configuration.poisson ? "poisson" : "fixed") << ")" << std::endl
+			  << "Service time:      " << configuration.service << " us ("
+			  << (configuration.mode == asyncOperation::ServiceMode::SPIN ? "spin" : "sleep") << ")" << std::endl
+			  << "Submitted:         " << submitted << " in " << submissionTime << " s" << std::endl
+			  << "Completed:         " << recorder.completedOperations.load() << " in " << elapsed << " s" << std::endl;
+	if (recorder.replayedOperations.load() > 0)
+		std::cout << "Replayed:          " << recorder.replayedOperations.load() << " (not measured)" << std::endl;
+	std::cout << "Throughput:        " << (elapsed > 0 ? recorder.completedOperations.load() / elapsed : 0.0) << " ops/s" << std::endl
+			  << "Concurrency limit: " << finalLimit << std::endl << std::endl
+			  << "Latency (us)           p50         p90         p99       p99.9         max" << std::endl;
+	showPercentiles("corrected", corrected);
+	showPercentiles("uncorrected", uncorrected);
+	if (completionJournal) {
+		const journal::CompletionJournal::Statistics statistics = completionJournal->getStatistics();
+		std::cout << std::endl << "Journal:           " << statistics.records << " records in " << statistics.batches
+				  << " group commits (" << statistics.bytes / 1024 << " KiB)" << std::endl;
+	}
+	if (stallWatchdog) {
+		const watchdog::Watchdog::Statistics statistics = stallWatchdog->getStatistics();
+		std::cout << std::endl << "Stalls:            " << statistics.operationStalls << " operations, "
+				  << statistics.dispatchStalls << " dispatches (longest "
+				  << std::chrono::duration_cast<std::chrono::milliseconds>(statistics.longestStall).count() << " ms)" << std::endl;
+	}
+	return EXIT_SUCCESS;
+}
@@ -7,6 +7,7 @@
 #ifndef LOGGER_LOGGER_HPP_
 #define LOGGER_LOGGER_HPP_
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -27,12 +28,32 @@ private:
 	 * Mutex used to lock the output
 	 */
 	static std::mutex mutex;
+	/**
+	 * Indicates whether the messages are displayed
+	 */
+	static std::atomic<bool> enabled;
 	/**
 	 * Class constructor
 	 */
 	Logger() {
 	};
 public:
+	/**
+	 * Enable or disable the messages (e.g. for load tests, where logging would dominate the cost
+	 * of the operations). They are enabled by default
+	 * @param[in] enable	Indicates whether the messages have to be displayed
+	 */
+	static void setEnabled(const bool enable) {
+		enabled.store(enable, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Verify whether the messages are displayed
+	 */
+	static bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
 	/**
 	 * Display a log message in a given output
 	 * @param[in] message	Message to display
@@ -40,6 +61,8 @@ public:
 	 * 						it the parameter is not defined
 	 */
 	static void log(const std::string &message, std::ostream& ostr = std::cout) {
+		if (!isEnabled())
+			return;
 		// Lock the output
 		std::lock_guard<std::mutex> locker(mutex);
 		// Put and flush the message
@@ -56,6 +79,42 @@ public:
 		log(message.str(), ostr);
 	}
 
+	/**
+	 * Build a message with a set of variables (e.g. to be written by a logging policy)
+	 * @param[in] message		Message to display at the beginning of the log
+	 * @param[in] operationId	Operation identifier that triggers the log generation
+	 * @param[in] threadId		Thread identifier which calls to this method
+	 * @param[in] time			Time to display in the log
+	 * @see policy::LoggingPolicy
+	 */
+	static std::string format(const std::string& message,
+							  const long long operationId,
+							  const std::thread::id threadId,
+							  const std::chrono::system_clock::time_point& time) {
+		return message + proactor::utils::Utils::tostr(operationId) +
+				" \t[thread: " + proactor::utils::Utils::tostr(threadId) + "] (" +
+				proactor::utils::Utils::dateToString(time) + ")";
+	}
+
+	/**
+	 * Build a message with a set of variables (e.g. to be written by a logging policy)
+	 * @param[in] message		Message to display at the beginning of the log
+	 * @param[in] operationId	Operation identifier that triggers the log generation
+	 * @param[in] threadId		Thread identifier which calls to this method
+	 * @param[in] startTime		Start time to compute the difference (elapsed time)
+	 * @param[in] endTime		Time to display in the log
+	 * @see policy::LoggingPolicy
+	 */
+	static std::string format(const std::string& message,
+							  const long long operationId,
+							  const std::thread::id threadId,
+							  const std::chrono::system_clock::time_point& startTime,
+							  const std::chrono::system_clock::time_point& endTime) {
+		return message + proactor::utils::Utils::tostr(operationId) +
+				" \t[thread: " + proactor::utils::Utils::tostr(threadId) + "] (" +
+				proactor::utils::Utils::dateToString(startTime, endTime) + ")";
+	}
+
 	/**
 	 * Display a message in a given output and give a set of variables
 	 * @param[in] message		Message to display at the beginning of the log
@@ -67,9 +126,9 @@ public:
 					const long long operationId,
 					const std::thread::id threadId,
 					const std::chrono::system_clock::time_point& time) {
-		log(message + proactor::utils::Utils::tostr(operationId) +
-				" \t[thread: " + proactor::utils::Utils::tostr(threadId) + "] (" +
-				proactor::utils::Utils::dateToString(time) + ")");
+		if (!isEnabled())
+			return;
+		log(format(message, operationId, threadId, time));
 	}
 
 	/**
@@ -85,14 +144,15 @@ public:
 					const std::thread::id threadId,
 					const std::chrono::system_clock::time_point& startTime,
 					const std::chrono::system_clock::time_point& endTime) {
-		log(message + proactor::utils::Utils::tostr(operationId) +
-				" \t[thread: " + proactor::utils::Utils::tostr(threadId) + "] (" +
-				proactor::utils::Utils::dateToString(startTime, endTime) + ")");
+		if (!isEnabled())
+			return;
+		log(format(message, operationId, threadId, startTime, endTime));
 	}
 };
 
 
 std::mutex Logger::mutex;
+std::atomic<bool> Logger::enabled(true);
 }
 }
 
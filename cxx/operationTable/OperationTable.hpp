@@ -0,0 +1,229 @@
+/**
+ * @file OperationTable.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Dense table of the operations accepted by the processor and not completed yet.
+ */
+
+#ifndef OPERATIONTABLE_OPERATIONTABLE_HPP_
+#define OPERATIONTABLE_OPERATIONTABLE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+
+namespace proactor {
+namespace operationTable {
+
+/**
+ * State of a slot of the table
+ */
+enum class OperationState : uint8_t {
+	/**
+	 * The slot is not used
+	 */
+	FREE,
+	/**
+	 * The operation is waiting for a worker
+	 */
+	QUEUED,
+	/**
+	 * The operation is being executed
+	 */
+	RUNNING
+};
+
+/**
+ * Summary of the operations in the table
+ */
+struct InFlightStatistics {
+	/**
+	 * Operations waiting for a worker
+	 */
+	size_t queued;
+	/**
+	 * Operations being executed
+	 */
+	size_t running;
+	/**
+	 * Time the oldest queued operation has been waiting
+	 */
+	std::chrono::nanoseconds oldestQueued;
+	/**
+	 * Time the oldest running operation has been executing
+	 */
+	std::chrono::nanoseconds oldestRunning;
+	/**
+	 * Identifier of the oldest running operation (0 if there is none)
+	 */
+	uint64_t oldestRunningId;
+};
+
+/**
+ * This class keeps the metadata of the non-completed operations as a structure of arrays indexed by
+ * slot: the state, the identifier and the submission and start times of each slot are stored in
+ * their own dense array. The slot of an operation is stored in the operation itself, so removing it
+ * does not search the table, and the slots are reused, so the table does not grow beyond the maximum
+ * number of operations in flight. The scans (e.g. getStatistics) only read the arrays they need,
+ * without dereferencing the operations.
+ * The slots have no generation: erase() detects an operation whose slot has been given to another
+ * operation, but not a late removal of an operation which has been submitted again (and may have got
+ * the same slot back). The processor never does it, as an operation is only removed once per
+ * submission, and the clients must not submit an operation again before it has been completed.
+ * It is not thread-safe: the processor accesses it with its lock held.
+ * @see asyncOperationProcessor::AsynchronousOperationProcessor
+ */
+template <typename T>
+class OperationTable {
+private:
+	/**
+	 * State of each slot
+	 */
+	std::vector<OperationState> states;
+	/**
+	 * Identifier of the operation in each slot
+	 */
+	std::vector<uint64_t> ids;
+	/**
+	 * Submission time of the operation in each slot (steady clock, in nanoseconds)
+	 */
+	std::vector<int64_t> submitTimes;
+	/**
+	 * Start time of the operation in each slot (steady clock, in nanoseconds)
+	 */
+	std::vector<int64_t> startTimes;
+	/**
+	 * Operation in each slot
+	 */
+	std::vector<asyncOperation::AsynchronousOperation<T>*> operations;
+	/**
+	 * Free slots (the last released one is reused first, as it is the most likely to be cached)
+	 */
+	std::vector<uint32_t> freeSlots;
+	/**
+	 * Number of used slots
+	 */
+	size_t used;
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] capacity	Initial number of slots (the table grows if they are exceeded)
+	 */
+	explicit OperationTable(const size_t capacity = 0) : used(0) {
+		reserve(capacity);
+	};
+
+	/**
+	 * Obtain the current time, as stored in the table
+	 */
+	static int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	/**
+	 * Make room for a number of slots
+	 * @param[in] capacity	Number of slots
+	 */
+	void reserve(const size_t capacity) {
+		states.reserve(capacity);
+		ids.reserve(capacity);
+		submitTimes.reserve(capacity);
+		startTimes.reserve(capacity);
+		operations.reserve(capacity);
+		freeSlots.reserve(capacity);
+	};
+
+	/**
+	 * Add a queued operation to the table. Its slot is stored in the operation
+	 * @param[in] operation		Operation
+	 * @param[in] submitTime	Submission time (see now())
+	 */
+	void insert(asyncOperation::AsynchronousOperation<T>* operation, const int64_t submitTime) {
+		uint32_t slot;
+		if (freeSlots.empty()) {
+			slot = static_cast<uint32_t>(states.size());
+			states.push_back(OperationState::FREE);
+			ids.push_back(0);
+			submitTimes.push_back(0);
+			startTimes.push_back(0);
+			operations.push_back(NULL);
+		} else {
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		states[slot] = OperationState::QUEUED;
+		ids[slot] = operation->getId();
+		submitTimes[slot] = submitTime;
+		startTimes[slot] = 0;
+		operations[slot] = operation;
+		operation->setSlot(slot);
+		++used;
+	};
+
+	/**
+	 * Indicate that an operation of the table has been picked up by a worker
+	 * @param[in] operation	Operation
+	 * @param[in] startTime	Start time (see now())
+	 */
+	void markRunning(const asyncOperation::AsynchronousOperation<T>* operation, const int64_t startTime) {
+		const uint32_t slot = operation->getSlot();
+		states[slot] = OperationState::RUNNING;
+		startTimes[slot] = startTime;
+	};
+
+	/**
+	 * Remove an operation from the table, releasing its slot
+	 * @param[in] operation	Operation
+	 * @return				False if the operation was not in the table
+	 */
+	bool erase(const asyncOperation::AsynchronousOperation<T>* operation) {
+		const uint32_t slot = operation->getSlot();
+		if ((slot >= states.size()) || (operations[slot] != operation) || (states[slot] == OperationState::FREE))
+			return false;
+		states[slot] = OperationState::FREE;
+		operations[slot] = NULL;
+		freeSlots.push_back(slot);
+		--used;
+		return true;
+	};
+
+	/**
+	 * Obtain the number of operations in the table
+	 */
+	size_t size() const {
+		return used;
+	};
+
+	/**
+	 * Summarize the operations in the table
+	 * @param[in] time	Current time (see now())
+	 */
+	InFlightStatistics getStatistics(const int64_t time) const {
+		InFlightStatistics statistics = InFlightStatistics();
+		int64_t oldestSubmit = time, oldestStart = time;
+		for (size_t slot = 0; slot < states.size(); ++slot) {
+			if (states[slot] == OperationState::QUEUED) {
+				++statistics.queued;
+				oldestSubmit = std::min(oldestSubmit, submitTimes[slot]);
+			} else if (states[slot] == OperationState::RUNNING) {
+				++statistics.running;
+				if (startTimes[slot] <= oldestStart) {
+					oldestStart = startTimes[slot];
+					statistics.oldestRunningId = ids[slot];
+				}
+			}
+		}
+		statistics.oldestQueued = std::chrono::nanoseconds(time - oldestSubmit);
+		statistics.oldestRunning = std::chrono::nanoseconds(time - oldestStart);
+		return statistics;
+	};
+};
+
+} /* namespace operationTable */
+} /* namespace proactor */
+
+#endif /* OPERATIONTABLE_OPERATIONTABLE_HPP_ */
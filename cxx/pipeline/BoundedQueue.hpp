@@ -0,0 +1,131 @@
+/**
+ * @file BoundedQueue.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Bounded blocking queue between the stages of a pipeline.
+ */
+
+#ifndef PIPELINE_BOUNDEDQUEUE_HPP_
+#define PIPELINE_BOUNDEDQUEUE_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "../exception/ShutdownException.hpp"
+
+namespace proactor {
+namespace pipeline {
+
+/**
+ * This class is a queue with a maximum size: the producers wait while it is full, so a slow
+ * consumer slows down its producers (back pressure) instead of making the queue grow. The items
+ * are moved in and out of the queue, never copied, so they can be move-only types.
+ */
+template <typename Item>
+class BoundedQueue {
+private:
+	/**
+	 * Maximum number of items
+	 */
+	const size_t capacity;
+	/**
+	 * Lock of the queue
+	 */
+	mutable std::mutex mutex;
+	/**
+	 * Condition variable used to wake up the consumers
+	 */
+	std::condition_variable notEmpty;
+	/**
+	 * Condition variable used to wake up the producers
+	 */
+	std::condition_variable notFull;
+	/**
+	 * Items of the queue
+	 */
+	std::deque<Item> items;
+	/**
+	 * Indicates that no more items are accepted
+	 */
+	bool closed;
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] capacity	Maximum number of items
+	 * @throw std::invalid_argument if the capacity is 0 (no item could ever be pushed)
+	 */
+	explicit BoundedQueue(const size_t capacity) : capacity(capacity), closed(false) {
+		if (capacity == 0)
+			throw std::invalid_argument("The capacity of a queue must be greater than 0");
+	};
+
+	/**
+	 * Add an item, waiting while the queue is full
+	 * @param[in] item	Item (moved into the queue)
+	 * @throw exception::ShutdownException if the queue has been closed
+	 */
+	void push(Item&& item) {
+		{
+			std::unique_lock<std::mutex> locker(mutex);
+			notFull.wait(locker, [&]{ return closed || items.size() < capacity;});
+			if (closed)
+				throw exception::ShutdownException();
+			items.push_back(std::move(item));
+		}
+		notEmpty.notify_one();
+	};
+
+	/**
+	 * Take the oldest item, waiting while the queue is empty
+	 * @param[out] item	Item (moved out of the queue)
+	 * @return			False if the queue has been closed and there are no items left
+	 */
+	bool pop(Item& item) {
+		{
+			std::unique_lock<std::mutex> locker(mutex);
+			notEmpty.wait(locker, [&]{ return closed || !items.empty();});
+			if (items.empty())
+				return false;
+			item = std::move(items.front());
+			items.pop_front();
+		}
+		notFull.notify_one();
+		return true;
+	};
+
+	/**
+	 * Stop accepting items. The consumers take the remaining items and then finish
+	 */
+	void close() {
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			closed = true;
+		}
+		notEmpty.notify_all();
+		notFull.notify_all();
+	};
+
+	/**
+	 * Obtain the number of items in the queue
+	 */
+	size_t size() const {
+		std::lock_guard<std::mutex> locker(mutex);
+		return items.size();
+	};
+
+	/**
+	 * Obtain the maximum number of items
+	 */
+	size_t getCapacity() const {
+		return capacity;
+	};
+};
+
+} /* namespace pipeline */
+} /* namespace proactor */
+
+#endif /* PIPELINE_BOUNDEDQUEUE_HPP_ */
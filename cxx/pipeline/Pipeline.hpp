@@ -0,0 +1,121 @@
+/**
+ * @file Pipeline.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Pipeline of stages connected by bounded queues (SEDA).
+ */
+
+#ifndef PIPELINE_PIPELINE_HPP_
+#define PIPELINE_PIPELINE_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Stage.hpp"
+
+namespace proactor {
+namespace pipeline {
+
+/**
+ * This class owns the stages of a pipeline and controls their life cycle. Requests whose phases
+ * have different costs (e.g. parse, compute and serialize) are split in stages, each one with its
+ * own workers, instead of being executed by a single operation:
+ * @code
+ * Pipeline pipeline;
+ * Stage<std::string, Request>& parse = pipeline.addStage<std::string, Request>("parse", 1, 64, parseRequest);
+ * Stage<Request, Response>& compute = pipeline.addStage<Request, Response>("compute", 4, 64, computeResponse);
+ * parse.connect(compute);
+ * compute.setSink(sendResponse);
+ * pipeline.start();
+ * parse.push(std::move(input));
+ * @endcode
+ * getStatistics() gives the utilization and queue depth of each stage, so the bottleneck can be found
+ * and given more workers.
+ * The pipeline is a standalone component: its stages do not run on the processor nor on an
+ * executor::SharedExecutor. A stage worker blocks while the queue of the next stage is full (this is
+ * how the back pressure is propagated), so the stages need threads of their own: on a shared pool,
+ * the blocked workers of the first stages could take all the threads and leave none for the stage
+ * which would drain them. Its stages can still submit operations to an InitiatorCompletion.
+ * @see Stage
+ */
+class Pipeline {
+private:
+	/**
+	 * Stages, in order
+	 */
+	std::vector<std::unique_ptr<StageBase> > stages;
+	/**
+	 * Indicates whether the stages are running
+	 */
+	bool running;
+
+public:
+	/**
+	 * Class constructor
+	 */
+	Pipeline() : running(false) {
+	};
+
+	/**
+	 * Class destructor. It stops the pipeline, if it is running
+	 */
+	virtual ~Pipeline() {
+		stop();
+	};
+
+	/**
+	 * Add a stage at the end of the pipeline. It has to be connected to the next stage (or given a sink)
+	 * @param[in] name		Name of the stage
+	 * @param[in] workers	Number of workers
+	 * @param[in] capacity	Capacity of the input queue
+	 * @param[in] function	Transformation of the stage
+	 * @return				Stage, which lives as long as the pipeline
+	 * @throw std::invalid_argument if there are no workers or the capacity is 0
+	 */
+	template <typename Input, typename Output>
+	Stage<Input, Output>& addStage(const std::string& name, const size_t workers, const size_t capacity,
+								   const typename Stage<Input, Output>::Function& function) {
+		Stage<Input, Output>* stage = new Stage<Input, Output>(name, workers, capacity, function);
+		stages.push_back(std::unique_ptr<StageBase>(stage));
+		return *stage;
+	};
+
+	/**
+	 * Start the workers of all the stages
+	 */
+	void start() {
+		if (running)
+			return;
+		for (std::unique_ptr<StageBase>& stage : stages)
+			stage->start();
+		running = true;
+	};
+
+	/**
+	 * Stop the pipeline: the first stage stops accepting items and each stage is stopped once the
+	 * previous one has finished, so all the items already accepted go through the whole pipeline
+	 */
+	void stop() {
+		if (!running)
+			return;
+		for (std::unique_ptr<StageBase>& stage : stages)
+			stage->stop();
+		running = false;
+	};
+
+	/**
+	 * Obtain the metrics of the stages, in order
+	 */
+	std::vector<StageStatistics> getStatistics() const {
+		std::vector<StageStatistics> statistics;
+		for (const std::unique_ptr<StageBase>& stage : stages)
+			statistics.push_back(stage->getStatistics());
+		return statistics;
+	};
+};
+
+} /* namespace pipeline */
+} /* namespace proactor */
+
+#endif /* PIPELINE_PIPELINE_HPP_ */
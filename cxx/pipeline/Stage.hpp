@@ -0,0 +1,272 @@
+/**
+ * @file Stage.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Stage of a pipeline: a bounded input queue served by its own workers.
+ */
+
+#ifndef PIPELINE_STAGE_HPP_
+#define PIPELINE_STAGE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../logger/Logger.hpp"
+#include "../trace/TraceRecorder.hpp"
+#include "BoundedQueue.hpp"
+
+namespace proactor {
+namespace pipeline {
+
+/**
+ * Metrics of a stage, used to find the bottleneck of a pipeline: the stage whose utilization is
+ * close to 1 and whose input queue is full has to be given more workers
+ */
+struct StageStatistics {
+	/**
+	 * Name of the stage
+	 */
+	std::string name;
+	/**
+	 * Number of workers
+	 */
+	size_t workers;
+	/**
+	 * Items in the input queue
+	 */
+	size_t queueDepth;
+	/**
+	 * Capacity of the input queue
+	 */
+	size_t queueCapacity;
+	/**
+	 * Processed items
+	 */
+	uint64_t processed;
+	/**
+	 * Items whose processing has thrown an exception (they are discarded)
+	 */
+	uint64_t failed;
+	/**
+	 * Fraction of the time the workers have been transforming items since the stage was started
+	 * (from 0 to 1). The time waiting for the next stage is not included
+	 */
+	double utilization;
+};
+
+/**
+ * Part of a stage which does not depend on the types of its items, so that a pipeline can manage
+ * stages of different types
+ */
+class StageBase {
+public:
+	virtual ~StageBase() {
+	};
+
+	/**
+	 * Start the workers of the stage
+	 */
+	virtual void start() = 0;
+
+	/**
+	 * Stop accepting items and wait until the workers have processed the ones in the queue
+	 */
+	virtual void stop() = 0;
+
+	/**
+	 * Obtain the metrics of the stage
+	 */
+	virtual StageStatistics getStatistics() const = 0;
+};
+
+/**
+ * This class is a stage of a pipeline (SEDA): its workers take the items from its bounded input
+ * queue, transform them and hand the results to the next stage (or to the sink of the pipeline).
+ * The items and results are moved from one stage to the next one, never copied. Each stage has its
+ * own workers, so a costly stage can be scaled without affecting the others, and the bounded queues
+ * propagate the back pressure of a saturated stage to the previous ones.
+ * @tparam Input	Type of the items (default constructible and movable)
+ * @tparam Output	Type of the results (movable)
+ * @see Pipeline
+ */
+template <typename Input, typename Output>
+class Stage : public StageBase {
+public:
+	/**
+	 * Function which transforms an item into a result
+	 */
+	typedef std::function<Output(Input&&)> Function;
+	/**
+	 * Function which receives the results (the input of the next stage or the sink)
+	 */
+	typedef std::function<void(Output&&)> Consumer;
+
+private:
+	/**
+	 * Name of the stage
+	 */
+	const std::string name;
+	/**
+	 * Number of workers
+	 */
+	const size_t workerCount;
+	/**
+	 * Input queue
+	 */
+	BoundedQueue<Input> queue;
+	/**
+	 * Transformation of the stage
+	 */
+	const Function function;
+	/**
+	 * Receiver of the results
+	 */
+	Consumer consumer;
+	/**
+	 * Workers of the stage
+	 */
+	std::vector<std::thread> workers;
+	/**
+	 * Time when the stage was started
+	 */
+	std::chrono::steady_clock::time_point startTime;
+	/**
+	 * Time the workers have been transforming items (in nanoseconds)
+	 */
+	std::atomic<uint64_t> busyTime;
+	/**
+	 * Processed items
+	 */
+	std::atomic<uint64_t> processed;
+	/**
+	 * Failed items
+	 */
+	std::atomic<uint64_t> failed;
+
+	/**
+	 * Add the time spent transforming an item to the busy time of the stage
+	 * @param[in] start	Time when the transformation started
+	 */
+	void addBusyTime(const std::chrono::steady_clock::time_point& start) {
+		busyTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+	};
+
+	/**
+	 * Main loop of the workers
+	 */
+	void work() {
+		trace::traceThreadName(name.c_str());
+		Input item;
+		while (queue.pop(item)) {
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			bool transformed = false;
+			try {
+				Output result = function(std::move(item));
+				transformed = true;
+				// The time blocked on a full next stage is not counted as busy, so that only the
+				// bottleneck (and not the stages before it) shows a high utilization
+				addBusyTime(start);
+				if (consumer)
+					consumer(std::move(result));
+				processed.fetch_add(1, std::memory_order_relaxed);
+			} catch (std::exception&) {
+				// The time spent on an item which fails is busy time too
+				if (!transformed)
+					addBusyTime(start);
+				failed.fetch_add(1, std::memory_order_relaxed);
+				logger::Logger::log("Item discarded by the stage " + name);
+			}
+		}
+	};
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] name			Name of the stage
+	 * @param[in] workers		Number of workers
+	 * @param[in] capacity		Capacity of the input queue
+	 * @param[in] function		Transformation of the stage. It is invoked concurrently if there are
+	 * 							several workers
+	 * @throw std::invalid_argument if there are no workers or the capacity is 0
+	 */
+	Stage(const std::string& name, const size_t workers, const size_t capacity, const Function& function) :
+		name(name), workerCount(workers), queue(capacity), function(function), busyTime(0), processed(0), failed(0) {
+		if (workers == 0)
+			throw std::invalid_argument("The stage " + name + " must have at least one worker");
+	};
+
+	/**
+	 * Class destructor. It stops the stage, if it is running
+	 */
+	virtual ~Stage() {
+		stop();
+	};
+
+	/**
+	 * Hand the results of this stage to the next one
+	 * @param[in] next	Next stage (it must outlive this one)
+	 */
+	template <typename NextOutput>
+	void connect(Stage<Output, NextOutput>& next) {
+		consumer = [&next](Output&& result) { next.push(std::move(result)); };
+	};
+
+	/**
+	 * Hand the results of this stage to a function (the end of the pipeline)
+	 * @param[in] sink	Function which receives the results. It is invoked concurrently if there are
+	 * 					several workers
+	 */
+	void setSink(const Consumer& sink) {
+		consumer = sink;
+	};
+
+	/**
+	 * Add an item to the input queue, waiting while it is full
+	 * @param[in] item	Item (moved into the queue)
+	 * @throw exception::ShutdownException if the stage has been stopped
+	 */
+	void push(Input&& item) {
+		queue.push(std::move(item));
+	};
+
+	void start() {
+		startTime = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < workerCount; ++i)
+			workers.push_back(std::thread(&Stage<Input, Output>::work, this));
+	};
+
+	void stop() {
+		queue.close();
+		for (std::thread& worker : workers)
+			worker.join();
+		workers.clear();
+	};
+
+	StageStatistics getStatistics() const {
+		StageStatistics statistics;
+		statistics.name = name;
+		statistics.workers = workerCount;
+		statistics.queueDepth = queue.size();
+		statistics.queueCapacity = queue.getCapacity();
+		statistics.processed = processed.load(std::memory_order_relaxed);
+		statistics.failed = failed.load(std::memory_order_relaxed);
+		const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+		statistics.utilization = (elapsed > 0) && (workerCount > 0) ?
+				busyTime.load(std::memory_order_relaxed) / (elapsed * workerCount) : 0.0;
+		return statistics;
+	};
+};
+
+} /* namespace pipeline */
+} /* namespace proactor */
+
+#endif /* PIPELINE_STAGE_HPP_ */
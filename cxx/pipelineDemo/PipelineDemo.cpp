@@ -0,0 +1,116 @@
+/**
+ * @file PipelineDemo.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Requests processed by a pipeline of three stages with different costs: parse (text to numbers),
+ * compute (sum of squares) and serialize (number to text). The costs are spent sleeping, as the
+ * blocking calls of a real service. The statistics of the stages show the bottleneck, which can be
+ * given more workers.
+ * Usage: PipelineDemo [ITEMS] [PARSE_WORKERS,COMPUTE_WORKERS,SERIALIZE_WORKERS]
+ *   (default: 2000 items, 1,1,1 workers)
+ * @see pipeline/Pipeline
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../pipeline/Pipeline.hpp"
+
+using namespace proactor;
+
+/**
+ * Cost of each stage (in microseconds)
+ */
+const unsigned int PARSE_COST = 100;
+const unsigned int COMPUTE_COST = 400;
+const unsigned int SERIALIZE_COST = 100;
+
+/**
+ * Parsed request. It is only moved between the stages
+ */
+typedef std::unique_ptr<std::vector<long long> > Request;
+
+Request parse(std::string&& text) {
+	std::this_thread::sleep_for(std::chrono::microseconds(PARSE_COST));
+	Request request(new std::vector<long long>());
+	std::istringstream stream(text);
+	long long number;
+	while (stream >> number)
+		request->push_back(number);
+	return request;
+}
+
+long long compute(Request&& request) {
+	std::this_thread::sleep_for(std::chrono::microseconds(COMPUTE_COST));
+	long long sum = 0;
+	for (long long number : *request)
+		sum += number * number;
+	return sum;
+}
+
+std::string serialize(long long&& result) {
+	std::this_thread::sleep_for(std::chrono::microseconds(SERIALIZE_COST));
+	return std::to_string(result);
+}
+
+int main(int argc, char *argv[]) {
+	const size_t items = (argc > 1) ? std::stoul(argv[1]) : 2000;
+	size_t workers[3] = {1, 1, 1};
+	if (argc > 2) {
+		std::istringstream stream(argv[2]);
+		char separator;
+		if (!(stream >> workers[0] >> separator >> workers[1] >> separator >> workers[2])) {
+			std::cerr << "Usage: " << argv[0] << " [ITEMS] [PARSE,COMPUTE,SERIALIZE]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::atomic<size_t> completed(0);
+	std::atomic<long long> checksum(0);
+	pipeline::Pipeline pipeline;
+	pipeline::Stage<std::string, Request>& parseStage =
+			pipeline.addStage<std::string, Request>("parse", workers[0], 64, parse);
+	pipeline::Stage<Request, long long>& computeStage =
+			pipeline.addStage<Request, long long>("compute", workers[1], 64, compute);
+	pipeline::Stage<long long, std::string>& serializeStage =
+			pipeline.addStage<long long, std::string>("serialize", workers[2], 64, serialize);
+	parseStage.connect(computeStage);
+	computeStage.connect(serializeStage);
+	serializeStage.setSink([&](std::string&& response) {
+		checksum.fetch_add(std::stoll(response));
+		completed.fetch_add(1);
+	});
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	pipeline.start();
+	long long expected = 0;
+	std::vector<pipeline::StageStatistics> statistics;
+	for (size_t i = 0; i < items; ++i) {
+		const long long a = i % 100, b = i % 7;
+		expected += a * a + b * b;
+		parseStage.push(std::to_string(a) + " " + std::to_string(b));
+		// Sample the statistics in the middle of the run, when the queues are in a steady state
+		if (i == items / 2)
+			statistics = pipeline.getStatistics();
+	}
+	pipeline.stop();
+	const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::fixed << std::setprecision(2)
+			  << "Stage        workers  utilization  queue depth" << std::endl;
+	for (const pipeline::StageStatistics& stage : statistics)
+		std::cout << std::left << std::setw(13) << stage.name << std::right << std::setw(7) << stage.workers
+				  << std::setw(13) << stage.utilization << std::setw(8) << stage.queueDepth << "/" << stage.queueCapacity << std::endl;
+	std::cout << "Completed " << completed.load() << " requests in " << elapsed << " s ("
+			  << std::setprecision(0) << completed.load() / elapsed << " requests/s), results "
+			  << (checksum.load() == expected ? "correct" : "WRONG") << std::endl;
+	return checksum.load() == expected ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file ExecutorPolicy.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Policies which define which threads execute the operations and dispatch their completions.
+ */
+
+#ifndef POLICY_EXECUTORPOLICY_HPP_
+#define POLICY_EXECUTORPOLICY_HPP_
+
+namespace proactor {
+namespace policy {
+
+/**
+ * The operations are executed by the workers of the processor and the completions are dispatched
+ * by the proactor thread (or inline in the workers, see asyncOperation::CompletionMode).
+ */
+struct ThreadPoolExecutor {
+	/**
+	 * The operations are not executed in the thread which submits them, but in the workers of the
+	 * processor (or the threads of its shared executor)
+	 */
+	static const bool CALLER_THREAD = false;
+};
+
+/**
+ * The operations are executed, and their completions dispatched, in the thread which submits them,
+ * before processOperation(s) returns. No thread is started. It is meant for tests and for
+ * deployments where the operations are cheap and the asynchrony is not needed.
+ */
+struct CallerThreadExecutor {
+	/**
+	 * The operations are executed in the thread which submits them
+	 */
+	static const bool CALLER_THREAD = true;
+};
+
+} /* namespace policy */
+} /* namespace proactor */
+
+#endif /* POLICY_EXECUTORPOLICY_HPP_ */
@@ -0,0 +1,116 @@
+/**
+ * @file LockingPolicy.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Policies which define how the queues of the engine are synchronized.
+ */
+
+#ifndef POLICY_LOCKINGPOLICY_HPP_
+#define POLICY_LOCKINGPOLICY_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace proactor {
+namespace policy {
+
+/**
+ * The queues are protected by a mutex and the waiting threads are blocked on a condition variable.
+ * It is the general purpose policy.
+ */
+struct MutexLocking {
+	typedef std::mutex Mutex;
+	typedef std::condition_variable ConditionVariable;
+	/**
+	 * The engine may be used from several threads
+	 */
+	static const bool SINGLE_THREAD = false;
+};
+
+/**
+ * Lock which spins (yielding the processor) instead of blocking the thread. It never enters the
+ * kernel when the lock is free or held for a short time, which is the case of the queues.
+ */
+class SpinLock {
+private:
+	std::atomic_flag flag;
+public:
+	SpinLock() {
+		flag.clear();
+	};
+
+	void lock() {
+		while (flag.test_and_set(std::memory_order_acquire))
+			std::this_thread::yield();
+	};
+
+	bool try_lock() {
+		return !flag.test_and_set(std::memory_order_acquire);
+	};
+
+	void unlock() {
+		flag.clear(std::memory_order_release);
+	};
+};
+
+/**
+ * The queues are protected by a spin lock. The threads which have to wait for an event (e.g. a free
+ * slot) still block on a condition variable.
+ */
+struct SpinLocking {
+	typedef SpinLock Mutex;
+	typedef std::condition_variable_any ConditionVariable;
+	static const bool SINGLE_THREAD = false;
+};
+
+/**
+ * Lock which does nothing, for engines used from a single thread
+ */
+struct NullMutex {
+	void lock() {
+	};
+
+	bool try_lock() {
+		return true;
+	};
+
+	void unlock() {
+	};
+};
+
+/**
+ * Condition variable for engines used from a single thread: waiting is an error, as nobody else
+ * could signal the condition
+ */
+struct NullConditionVariable {
+	template <typename Lock, typename Predicate>
+	void wait(Lock&, Predicate predicate) {
+		if (!predicate())
+			throw std::logic_error("The thread would wait forever in a single-thread engine");
+	};
+
+	void notify_one() {
+	};
+
+	void notify_all() {
+	};
+};
+
+/**
+ * No synchronization at all. It requires the CallerThreadExecutor, so that the operations and
+ * their completions are all run by the thread which submits them.
+ * @see ExecutorPolicy
+ */
+struct SingleThreadLocking {
+	typedef NullMutex Mutex;
+	typedef NullConditionVariable ConditionVariable;
+	static const bool SINGLE_THREAD = true;
+};
+
+} /* namespace policy */
+} /* namespace proactor */
+
+#endif /* POLICY_LOCKINGPOLICY_HPP_ */
@@ -0,0 +1,125 @@
+/**
+ * @file LoggingPolicy.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Policies which define how the engine logs its activity.
+ */
+
+#ifndef POLICY_LOGGINGPOLICY_HPP_
+#define POLICY_LOGGINGPOLICY_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+namespace proactor {
+namespace policy {
+
+/**
+ * Nothing is logged. As isEnabled is a constant, the messages are not even built: the callers
+ * check it before formatting them, and the compiler removes the whole block.
+ */
+struct NoLogging {
+	static constexpr bool isEnabled() {
+		return false;
+	};
+
+	static void log(const std::string&) {
+	};
+};
+
+/**
+ * The messages are written by the calling thread (see logger::Logger), which can be enabled and
+ * disabled at runtime.
+ */
+struct SyncLogging {
+	static bool isEnabled() {
+		return logger::Logger::isEnabled();
+	};
+
+	static void log(const std::string& message) {
+		logger::Logger::log(message);
+	};
+};
+
+/**
+ * The messages are queued and written by a background thread, so the calling thread does not wait
+ * for the output. The pending messages are written when the program finishes.
+ */
+class AsyncLogging {
+private:
+	/**
+	 * Background writer shared by all the engines
+	 */
+	class Writer {
+	private:
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::deque<std::string> messages;
+		bool stop;
+		std::thread thread;
+
+		void write() {
+			std::deque<std::string> batch;
+			std::unique_lock<std::mutex> locker(mutex);
+			while (true) {
+				cv.wait(locker, [&]{ return stop || !messages.empty();});
+				if (messages.empty())
+					return;
+				batch.swap(messages);
+				locker.unlock();
+				for (const std::string& message : batch)
+					std::cout << message << '\n';
+				std::cout << std::flush;
+				batch.clear();
+				locker.lock();
+			}
+		};
+
+	public:
+		Writer() : stop(false), thread(&Writer::write, this) {
+		};
+
+		~Writer() {
+			{
+				std::lock_guard<std::mutex> locker(mutex);
+				stop = true;
+			}
+			cv.notify_one();
+			thread.join();
+		};
+
+		void push(const std::string& message) {
+			{
+				std::lock_guard<std::mutex> locker(mutex);
+				messages.push_back(message);
+			}
+			cv.notify_one();
+		};
+	};
+
+	static Writer& writer() {
+		static Writer instance;
+		return instance;
+	};
+
+public:
+	static bool isEnabled() {
+		return logger::Logger::isEnabled();
+	};
+
+	static void log(const std::string& message) {
+		if (isEnabled())
+			writer().push(message);
+	};
+};
+
+} /* namespace policy */
+} /* namespace proactor */
+
+#endif /* POLICY_LOGGINGPOLICY_HPP_ */
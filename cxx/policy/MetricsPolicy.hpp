@@ -0,0 +1,99 @@
+/**
+ * @file MetricsPolicy.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Policies which define which metrics the processor collects.
+ */
+
+#ifndef POLICY_METRICSPOLICY_HPP_
+#define POLICY_METRICSPOLICY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+
+namespace proactor {
+namespace policy {
+
+/**
+ * No metrics are collected: the hooks are empty and compiled away
+ */
+struct NoMetrics {
+	void onAccepted(const size_t) {
+	};
+
+	template <typename T>
+	void onExecuted(const asyncOperation::AsynchronousOperation<T>*) {
+	};
+};
+
+/**
+ * Counters of the processed operations and of the time they spend queued and executing. They
+ * are updated with relaxed atomic operations, outside any lock.
+ */
+class CountingMetrics {
+public:
+	/**
+	 * Values of the counters at a given time
+	 */
+	struct Snapshot {
+		/**
+		 * Accepted operations
+		 */
+		uint64_t accepted;
+		/**
+		 * Executed operations
+		 */
+		uint64_t executed;
+		/**
+		 * Total time between the submission and the start of the executed operations (in nanoseconds)
+		 */
+		uint64_t queueingTime;
+		/**
+		 * Total execution time of the executed operations (in nanoseconds)
+		 */
+		uint64_t executionTime;
+	};
+
+private:
+	std::atomic<uint64_t> accepted;
+	std::atomic<uint64_t> executed;
+	std::atomic<uint64_t> queueingTime;
+	std::atomic<uint64_t> executionTime;
+
+public:
+	CountingMetrics() : accepted(0), executed(0), queueingTime(0), executionTime(0) {
+	};
+
+	void onAccepted(const size_t count) {
+		accepted.fetch_add(count, std::memory_order_relaxed);
+	};
+
+	template <typename T>
+	void onExecuted(const asyncOperation::AsynchronousOperation<T>* operation) {
+		executed.fetch_add(1, std::memory_order_relaxed);
+		queueingTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				operation->getStartTime() - operation->getSubmitTime()).count(), std::memory_order_relaxed);
+		executionTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				operation->getEndTime() - operation->getStartTime()).count(), std::memory_order_relaxed);
+	};
+
+	/**
+	 * Obtain the values of the counters
+	 */
+	Snapshot getSnapshot() const {
+		Snapshot snapshot;
+		snapshot.accepted = accepted.load(std::memory_order_relaxed);
+		snapshot.executed = executed.load(std::memory_order_relaxed);
+		snapshot.queueingTime = queueingTime.load(std::memory_order_relaxed);
+		snapshot.executionTime = executionTime.load(std::memory_order_relaxed);
+		return snapshot;
+	};
+};
+
+} /* namespace policy */
+} /* namespace proactor */
+
+#endif /* POLICY_METRICSPOLICY_HPP_ */
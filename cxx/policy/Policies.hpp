@@ -0,0 +1,57 @@
+/**
+ * @file Policies.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Compile-time configuration of the engine.
+ */
+
+#ifndef POLICY_POLICIES_HPP_
+#define POLICY_POLICIES_HPP_
+
+#include "ExecutorPolicy.hpp"
+#include "LockingPolicy.hpp"
+#include "LoggingPolicy.hpp"
+#include "MetricsPolicy.hpp"
+
+namespace proactor {
+namespace policy {
+
+/**
+ * This class groups the policies which configure the engine (InitiatorCompletion and its
+ * components) at compile time. The features which are not selected do not cost anything at
+ * runtime: there is no flag to check nor virtual call to make.
+ * The logging policy applies to the messages of the engine, including the ones of the operations it
+ * executes. The messages of the exceptions and of the components used outside the engine (e.g. the
+ * journal or the watchdog) are still written with logger::Logger.
+ * @tparam LockingType		How the queues are synchronized (MutexLocking, SpinLocking or SingleThreadLocking)
+ * @tparam ExecutorType		Which threads execute the operations (ThreadPoolExecutor or CallerThreadExecutor)
+ * @tparam LoggingType		How the activity is logged (NoLogging, SyncLogging or AsyncLogging)
+ * @tparam MetricsType		Which metrics are collected (NoMetrics or CountingMetrics)
+ */
+template <typename LockingType, typename ExecutorType, typename LoggingType, typename MetricsType>
+struct Policies {
+	typedef LockingType Locking;
+	typedef ExecutorType Executor;
+	typedef LoggingType Logging;
+	typedef MetricsType Metrics;
+
+	static_assert(!Locking::SINGLE_THREAD || Executor::CALLER_THREAD,
+			"A single-thread engine must execute the operations in the caller thread");
+};
+
+/**
+ * Configuration of the engine by default: workers and proactor thread synchronized with mutexes,
+ * logging which can be disabled at runtime and no metrics
+ */
+typedef Policies<MutexLocking, ThreadPoolExecutor, SyncLogging, NoMetrics> DefaultPolicies;
+
+/**
+ * Minimal configuration: everything is done in the caller thread, without synchronization,
+ * logging nor metrics
+ */
+typedef Policies<SingleThreadLocking, CallerThreadExecutor, NoLogging, NoMetrics> MinimalPolicies;
+
+} /* namespace policy */
+} /* namespace proactor */
+
+#endif /* POLICY_POLICIES_HPP_ */
@@ -0,0 +1,89 @@
+/**
+ * @file PolicyOverhead.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Overhead of the engine with each configuration of policies: time per operation of trivial
+ * operations submitted one at a time, from the submission to the completion of the last one, compared
+ * with executing the operations directly. The features which are not selected must not cost anything.
+ * Usage: PolicyOverhead [OPERATIONS]
+ *   (default: 200000 operations per configuration)
+ * @see policy/Policies
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../check/CompletionCounter.hpp"
+#include "../check/TestOperation.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../logger/Logger.hpp"
+#include "../policy/Policies.hpp"
+
+using namespace proactor;
+
+/**
+ * Display the time per operation of a configuration
+ * @param[in] name			Name of the configuration
+ * @param[in] elapsed		Time to process all the operations
+ * @param[in] operations	Number of operations
+ * @param[in] correct		Indicates whether all the operations have been completed
+ */
+void report(const std::string& name, const std::chrono::steady_clock::duration& elapsed, const size_t operations,
+			const bool correct) {
+	std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(1)
+			  << std::setw(10) << std::chrono::duration<double, std::nano>(elapsed).count() / operations << " ns/op"
+			  << (correct ? "" : "  LOST COMPLETIONS") << std::endl;
+}
+
+/**
+ * Measure an engine configured with a set of policies
+ * @tparam Policies			Configuration of the engine
+ * @param[in] name			Name of the configuration
+ * @param[in] mode			Completion mode of the engine
+ * @param[in] operations	Number of operations
+ */
+template <typename Policies>
+void measure(const std::string& name, const asyncOperation::CompletionMode mode, const size_t operations) {
+	std::vector<check::TestOperation> trivial(operations);
+	check::CompletionCounter counter;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		initiatorCompletion::InitiatorCompletion<long, Policies> initiator(&counter, mode, 4);
+		for (check::TestOperation& operation : trivial)
+			initiator.processOperation(&operation);
+		initiator.shutdown(initiatorCompletion::ShutdownMode::GRACEFUL);
+	}
+	report(name, std::chrono::steady_clock::now() - start, operations, counter.completed.load() == operations);
+}
+
+int main(int argc, char *argv[]) {
+	const size_t operations = (argc > 1) ? std::stoul(argv[1]) : 200000;
+	if (operations == 0) {
+		std::cerr << "Usage: " << argv[0] << " [OPERATIONS]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	logger::Logger::setEnabled(false);
+	using namespace policy;
+
+	// Reference: the operations executed directly, without the engine
+	std::vector<check::TestOperation> trivial(operations);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (check::TestOperation& operation : trivial)
+		operation.execute<NoLogging>();
+	report("direct execution", std::chrono::steady_clock::now() - start, operations, true);
+
+	measure<DefaultPolicies>("default, 4 workers, serialized", asyncOperation::CompletionMode::SERIALIZED, operations);
+	measure<DefaultPolicies>("default, 4 workers, inline", asyncOperation::CompletionMode::INLINE, operations);
+	measure<Policies<SpinLocking, ThreadPoolExecutor, NoLogging, NoMetrics> >("spin locks, 4 workers, inline",
+			asyncOperation::CompletionMode::INLINE, operations);
+	measure<Policies<MutexLocking, CallerThreadExecutor, SyncLogging, NoMetrics> >("mutexes, caller thread, logging disabled",
+			asyncOperation::CompletionMode::INLINE, operations);
+	measure<Policies<MutexLocking, CallerThreadExecutor, NoLogging, CountingMetrics> >("mutexes, caller thread, counting metrics",
+			asyncOperation::CompletionMode::INLINE, operations);
+	measure<MinimalPolicies>("minimal", asyncOperation::CompletionMode::INLINE, operations);
+	return EXIT_SUCCESS;
+}
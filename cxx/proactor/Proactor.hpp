@@ -7,35 +7,34 @@
 #ifndef PROACTOR_PROACTOR_HPP_
 #define PROACTOR_PROACTOR_HPP_
 
-#include <condition_variable>
+#include <atomic>
+#include <future>
 #include <memory>
-#include <mutex>
 #include "../completionEventQueue/CompletionEventQueue.hpp"
-#include "../logger/Logger.hpp"
+#include "../executor/SharedExecutor.hpp"
 #include "../observer/Observer.hpp"
+#include "../policy/Policies.hpp"
+#include "../trace/TraceRecorder.hpp"
 #include "../utils/Utils.hpp"
+#include "../watchdog/Watchdog.hpp"
 
 namespace proactor {
 namespace proactor {
 
-/**
- * Time to keep waiting until checking whether there are more events in the completion event
- * queue
- */
-static const unsigned short WAIT_TIME = 1000;
-
 /**
  * This is the Proactor. Its mission is dequeuing completion events and then
- * notifying it to the IniitiatorCompletion handler.
+ * notifying it to the IniitiatorCompletion handler. It runs in its own thread (exec) or, once
+ * attached to a shared executor, as a task per completion event.
+ * @tparam Policies	Configuration of the engine
  */
-template <typename T>
-class Proactor {
+template <typename T, typename Policies = policy::DefaultPolicies>
+class Proactor : public executor::TaskSource {
 private:
 	/**
 	 * Queue with the completion event queue. It is being checked whether it contains
 	 * or not completed operations
 	 */
-	std::shared_ptr<completionEventQueue::CompletionEventQueue<T> > completionEventQueue;
+	std::shared_ptr<completionEventQueue::CompletionEventQueue<T, Policies> > completionEventQueue;
 	/**
 	 * Observer to notify that an operation has been completed. It implements the
 	 * observer design pattern
@@ -45,7 +44,27 @@ private:
 	 * Indicates whether the process is requested to be finished. I will not be finished
 	 * until there are operations in the completion event queue or waiting to be finished
 	 */
-	bool finish;
+	std::atomic<bool> finish;
+	/**
+	 * Watchdog of the dispatch of completions (optional)
+	 */
+	std::shared_ptr<watchdog::Watchdog> stallWatchdog;
+	/**
+	 * Shared executor which dispatches the completions, if the proactor does not run in its own thread
+	 */
+	std::shared_ptr<executor::SharedExecutor> sharedExecutor;
+	/**
+	 * Registration of the proactor in the shared executor
+	 */
+	executor::SharedExecutor::Client* executorClient;
+	/**
+	 * Indicates that the last completion has been dispatched by the shared executor
+	 */
+	std::atomic<bool> drained;
+	/**
+	 * Fulfilled when the last completion has been dispatched by the shared executor
+	 */
+	std::promise<void> finished;
 
 public:
 	/**
@@ -54,55 +73,100 @@ public:
 	 * 									operations
 	 * @param[in] observer				Observer of this instance. The observer will be notified
 	 * 									that an operation has been completed
+	 * @param[in] watchdog				Watchdog which reports the completions whose dispatch takes too long
+	 * 									(optional)
 	 */
-	Proactor(std::shared_ptr<completionEventQueue::CompletionEventQueue<T> > completionEventQueue,
-			 observer::Observer<asyncOperation::AsynchronousOperation<T> > *observer) :
+	Proactor(std::shared_ptr<completionEventQueue::CompletionEventQueue<T, Policies> > completionEventQueue,
+			 observer::Observer<asyncOperation::AsynchronousOperation<T> > *observer,
+			 const std::shared_ptr<watchdog::Watchdog>& watchdog = nullptr) :
 				 completionEventQueue(completionEventQueue),
 				 observer(observer) ,
-				 finish(false) {
+				 finish(false),
+				 stallWatchdog(watchdog),
+				 executorClient(NULL),
+				 drained(false) {
 	};
 
 	/**
 	 * Class destructor
 	 */
 	virtual ~Proactor() {
-		logger::Logger::log("Finished Proactor.");
+		if (executorClient) {
+			completionEventQueue->setWakeup(nullptr);
+			sharedExecutor->detach(executorClient);
+		}
+		Policies::Logging::log("Finished Proactor.");
 	};
 
 	/**
-	 * Indicate that the proactor can finish its execution thread
+	 * Indicate that the proactor can finish its execution thread. Once it has been called to be
+	 * finished, it cannot be resumed.
 	 * @param[in] finish	Indicates the finishing status (i.e. whether it can be finished or not)
 	 */
 	void canFinish(const bool finish) {
-		this->finish = finish;
+		if (finish && !this->finish.exchange(true))
+			completionEventQueue->close();
 	}
 
 	/**
-	 * This method checks the completion event queue until the proactor is called to be finished.
+	 * This method waits for completion events until the proactor is called to be finished.
 	 * In case there is a new competed operations, it notifies the observer.
 	 * In case the proactor is called to be finished, it wait until there are no more processes
 	 * in the completion event queue and there are no operations being waiting to be completed
 	 */
 	void exec() {
-
+		trace::traceThreadName("proactor");
+		watchdog::ActivitySlot* slot = stallWatchdog ? stallWatchdog->registerThread(watchdog::StallKind::DISPATCH, "proactor") : NULL;
 		// The loop terminates when the proactor is called to be finished and all the operations
 		// have been processed (including the ones which were being processed)
-		while(!finish || completionEventQueue->arePendingOperations()) {
-
-			// Wait for a new completed operation
-			while ((completionEventQueue->size() == 0) && (!finish) )
-				std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_TIME));
-
-			// In case there are new competed events, notify the observer
-			if (completionEventQueue->size() > 0) {
-				logger::Logger::log("Proactor removes  element from queue (size: " +
+		asyncOperation::AsynchronousOperation<T>* myoperation = NULL;
+		while (completionEventQueue->waitAndPop(myoperation)) {
+			if (Policies::Logging::isEnabled())
+				Policies::Logging::log("Proactor removes  element from queue (remaining: " +
 						utils::Utils::tostr(completionEventQueue->size()) + ")...");
-				asyncOperation::AsynchronousOperation<T>* myoperation = completionEventQueue->pop();
-				observer->notify(myoperation);
-			}
+			if (slot)
+				slot->begin(myoperation->getId());
+			observer->notify(myoperation);
+			if (slot)
+				slot->end();
 		} // The proactor is called to be finished
+		if (slot)
+			stallWatchdog->unregisterThread(slot);
+
+		Policies::Logging::log("Proactor execution finished.");
+	};
 
-		logger::Logger::log("Proactor execution finished.");
+	/**
+	 * Dispatch the completions in a shared executor instead of exec. They are still dispatched one
+	 * after another: the executor runs a single task of the proactor at a time
+	 * @param[in] executor	Shared executor
+	 * @return				Future which is ready once the proactor has finished (as exec returning)
+	 */
+	std::shared_future<void> attach(const std::shared_ptr<executor::SharedExecutor>& executor) {
+		sharedExecutor = executor;
+		executorClient = executor->attach(this, watchdog::StallKind::DISPATCH, 1, 1);
+		completionEventQueue->setWakeup([this]() { sharedExecutor->submit(executorClient); });
+		return finished.get_future().share();
+	};
+
+	/**
+	 * Dispatch the next completion event, if any (a task of the shared executor)
+	 * @param[in] slot	Slot where the activity of the thread is published (NULL if it is not watched)
+	 */
+	void runTask(watchdog::ActivitySlot* slot) {
+		asyncOperation::AsynchronousOperation<T>* myoperation = NULL;
+		bool queueFinished = false;
+		if (completionEventQueue->tryPop(myoperation, queueFinished)) {
+			if (slot)
+				slot->begin(myoperation->getId());
+			observer->notify(myoperation);
+			if (slot)
+				slot->end();
+		}
+		if (queueFinished && !drained.exchange(true)) {
+			Policies::Logging::log("Proactor execution finished.");
+			finished.set_value();
+		}
 	};
 
 };
@@ -0,0 +1,99 @@
+/**
+ * @file OperationRegistry.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Registry of the types of operations which can be created from their serialized arguments.
+ */
+
+#ifndef REGISTRY_OPERATIONREGISTRY_HPP_
+#define REGISTRY_OPERATIONREGISTRY_HPP_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "../asyncOperation/AsynchronousOperation.hpp"
+#include "../exception/UnknownOperationTypeException.hpp"
+
+namespace proactor {
+namespace registry {
+
+/**
+ * This class keeps the factories of the serializable operations, indexed by the name of their
+ * type (AsynchronousOperation::getTypeName). It is used to re-create operations which have been
+ * serialized (e.g. in a journal).
+ * @see asyncOperation/AsynchronousOperation
+ */
+template <typename T>
+class OperationRegistry {
+public:
+	/**
+	 * Function which creates an operation from its serialized arguments
+	 */
+	typedef std::function<asyncOperation::AsynchronousOperation<T>*(const std::string&)> Factory;
+
+private:
+	/**
+	 * Lock of the factories
+	 */
+	mutable std::mutex mutex;
+	/**
+	 * Factories indexed by the name of the type
+	 */
+	std::map<std::string, Factory> factories;
+
+public:
+	/**
+	 * Register a type of operation
+	 * @param[in] typeName	Name of the type
+	 * @param[in] factory	Function which creates an operation of the type from its serialized arguments
+	 */
+	void registerType(const std::string& typeName, const Factory& factory) {
+		std::lock_guard<std::mutex> locker(mutex);
+		factories[typeName] = factory;
+	};
+
+	/**
+	 * Register a type of operation which provides the static methods typeName() and
+	 * deserialize(arguments)
+	 */
+	template <typename Operation>
+	void registerType() {
+		registerType(Operation::typeName(), &Operation::deserialize);
+	};
+
+	/**
+	 * Verify whether a type of operation is registered
+	 * @param[in] typeName	Name of the type
+	 */
+	bool isRegistered(const std::string& typeName) const {
+		std::lock_guard<std::mutex> locker(mutex);
+		return factories.find(typeName) != factories.end();
+	};
+
+	/**
+	 * Create an operation
+	 * @param[in] typeName	Name of the type of the operation
+	 * @param[in] arguments	Serialized arguments of the operation
+	 * @return				New operation
+	 * @throw exception::UnknownOperationTypeException if the type is not registered
+	 */
+	std::unique_ptr<asyncOperation::AsynchronousOperation<T> > create(const std::string& typeName, const std::string& arguments) const {
+		Factory factory;
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			typename std::map<std::string, Factory>::const_iterator iter = factories.find(typeName);
+			if (iter == factories.end())
+				throw exception::UnknownOperationTypeException("Unknown operation type: " + typeName);
+			factory = iter->second;
+		}
+		return std::unique_ptr<asyncOperation::AsynchronousOperation<T> >(factory(arguments));
+	};
+};
+
+} /* namespace registry */
+} /* namespace proactor */
+
+#endif /* REGISTRY_OPERATIONREGISTRY_HPP_ */
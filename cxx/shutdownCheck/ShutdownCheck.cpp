@@ -0,0 +1,135 @@
+/**
+ * @file ShutdownCheck.cpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * Check the latency of the shutdown of the engine. An idle engine must shut down at once. With a
+ * backlog of accepted operations waiting for the threads of a shared executor, a graceful shutdown
+ * must return as soon as the backlog has been drained, and an abort as soon as the running
+ * operations have finished. Meanwhile, a thread blocked submitting more operations must be
+ * rejected. The program fails if any shutdown exceeds its bound.
+ * Usage: ShutdownCheck
+ * @see initiatorCompletion/InitiatorCompletion (shutdown)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../check/CompletionCounter.hpp"
+#include "../check/TestOperation.hpp"
+#include "../exception/ShutdownException.hpp"
+#include "../executor/SharedExecutor.hpp"
+#include "../initiatorCompletion/InitiatorCompletion.hpp"
+#include "../logger/Logger.hpp"
+
+using namespace proactor;
+
+/**
+ * Duration of the operations
+ */
+const std::chrono::milliseconds SERVICE_TIME(25);
+/**
+ * Operations accepted by the engine (its pool size)
+ */
+const size_t BACKLOG = 16;
+/**
+ * Threads of the shared executor which executes the backlog
+ */
+const size_t EXECUTOR_THREADS = 2;
+/**
+ * Tolerance of the bounds (scheduling delays)
+ */
+const std::chrono::milliseconds TOLERANCE(100);
+
+/**
+ * Display the result of a check
+ * @param[in] name		Name of the check
+ * @param[in] elapsed	Latency of the shutdown
+ * @param[in] bound		Maximum latency allowed
+ * @param[in] passed	Indicates whether the other conditions of the check hold
+ * @param[in] details	Description of the other conditions
+ * @return				True if the check has passed
+ */
+bool report(const std::string& name, const std::chrono::steady_clock::duration& elapsed,
+			const std::chrono::milliseconds& bound, const bool passed, const std::string& details) {
+	const bool inTime = elapsed <= bound;
+	std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+			  << std::setw(8) << std::chrono::duration<double, std::milli>(elapsed).count() << " ms (bound "
+			  << bound.count() << " ms)  " << details << ((inTime && passed) ? "" : "  FAILED") << std::endl;
+	return inTime && passed;
+}
+
+/**
+ * Shut down an engine which has no operation
+ * @return	True if the check has passed
+ */
+bool checkIdle() {
+	check::CompletionCounter counter;
+	initiatorCompletion::InitiatorCompletion<long> initiator(&counter, asyncOperation::CompletionMode::SERIALIZED, 4);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const bool drained = initiator.shutdown(initiatorCompletion::ShutdownMode::GRACEFUL, std::chrono::seconds(5));
+	return report("idle, graceful", std::chrono::steady_clock::now() - start, TOLERANCE, drained, "");
+}
+
+/**
+ * Shut down an engine with a backlog: BACKLOG operations accepted, of which EXECUTOR_THREADS are
+ * running, and a thread blocked submitting more operations
+ * @param[in] mode	Shutdown mode
+ * @return			True if the check has passed
+ */
+bool checkBacklog(const initiatorCompletion::ShutdownMode mode) {
+	const bool graceful = (mode == initiatorCompletion::ShutdownMode::GRACEFUL);
+	std::shared_ptr<executor::SharedExecutor> executor = std::make_shared<executor::SharedExecutor>(EXECUTOR_THREADS);
+	std::vector<std::unique_ptr<check::TestOperation> > operations;
+	for (size_t i = 0; i < BACKLOG * 4; ++i)
+		operations.emplace_back(new check::TestOperation(SERVICE_TIME));
+	check::CompletionCounter counter;
+	initiatorCompletion::InitiatorCompletion<long> initiator(&counter, asyncOperation::CompletionMode::SERIALIZED, BACKLOG,
+			nullptr, nullptr, executor);
+
+	// The submitter blocks once the pool is full, until the shutdown rejects it
+	std::atomic<size_t> accepted(0);
+	std::atomic<bool> rejected(false);
+	std::thread submitter([&]() {
+		try {
+			for (std::unique_ptr<check::TestOperation>& operation : operations) {
+				initiator.processOperation(operation.get());
+				accepted.fetch_add(1);
+			}
+		} catch (exception::ShutdownException&) {
+			rejected.store(true);
+		}
+	});
+	while (accepted.load() < BACKLOG)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const bool drained = initiator.shutdown(mode, std::chrono::seconds(5));
+	const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+	submitter.join();
+
+	// A graceful shutdown executes the whole backlog, in rounds of EXECUTOR_THREADS operations. An abort
+	// only waits for the running operations
+	const size_t completed = counter.completed.load();
+	const size_t rounds = graceful ? (BACKLOG + EXECUTOR_THREADS - 1) / EXECUTOR_THREADS : 1;
+	const bool completions = graceful ? (completed == accepted.load()) : (completed < accepted.load());
+	return report(graceful ? "backlog, graceful" : "backlog, abort pending", elapsed, SERVICE_TIME * rounds + TOLERANCE,
+				  drained && rejected.load() && completions,
+				  utils::Utils::tostr(completed) + "/" + utils::Utils::tostr(accepted.load()) + " completed, submitter " +
+				  (rejected.load() ? "rejected" : "NOT rejected"));
+}
+
+int main() {
+	logger::Logger::setEnabled(false);
+	bool passed = checkIdle();
+	passed &= checkBacklog(initiatorCompletion::ShutdownMode::GRACEFUL);
+	passed &= checkBacklog(initiatorCompletion::ShutdownMode::ABORT_PENDING);
+	std::cout << (passed ? "PASSED" : "FAILED: a shutdown is too slow or incomplete") << std::endl;
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
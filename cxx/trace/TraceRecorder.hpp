@@ -0,0 +1,318 @@
+/**
+ * @file TraceRecorder.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Records the lifecycle events of the operations and exports them in the Chrome
+ * trace-event format (which can be opened with Perfetto or chrome://tracing).
+ */
+
+#ifndef TRACE_TRACERECORDER_HPP_
+#define TRACE_TRACERECORDER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace proactor {
+namespace trace {
+
+/**
+ * Indicates whether the tracing support is compiled in (build with -DPROACTOR_TRACE). If it is not,
+ * the calls to traceEvent are removed by the compiler
+ */
+#ifdef PROACTOR_TRACE
+static const bool TRACE_COMPILED = true;
+#else
+static const bool TRACE_COMPILED = false;
+#endif
+
+/**
+ * Events of the lifecycle of an operation
+ */
+enum class TraceEvent : unsigned char {
+	/**
+	 * The operation has been accepted by the processor
+	 */
+	SUBMIT,
+	/**
+	 * A worker starts the execution of the operation
+	 */
+	START,
+	/**
+	 * A worker finishes the execution of the operation
+	 */
+	END,
+	/**
+	 * The completion event has been put in the completion event queue
+	 */
+	ENQUEUE_COMPLETION,
+	/**
+	 * The completion has been dispatched to the Initiator/Completion handler
+	 */
+	NOTIFY
+};
+
+/**
+ * This class records trace events in per-thread buffers, so that the threads do not
+ * contend with each other, and exports them as Chrome trace-event JSON.
+ * The buffers are kept after the threads finish, until clear() is called.
+ */
+class TraceRecorder {
+private:
+	/**
+	 * Recorded event
+	 */
+	struct Record {
+		/**
+		 * Type of event
+		 */
+		TraceEvent event;
+		/**
+		 * Identifier of the operation
+		 */
+		unsigned long long operationId;
+		/**
+		 * Time of the event (in nanoseconds since the recorder epoch)
+		 */
+		long long timestamp;
+	};
+
+	/**
+	 * Buffer of the events recorded by a thread
+	 */
+	struct ThreadBuffer {
+		/**
+		 * Identifier of the thread in the trace
+		 */
+		unsigned int threadId;
+		/**
+		 * Name of the thread in the trace
+		 */
+		std::string name;
+		/**
+		 * Lock used only to export the buffer while the thread is recording (uncontended otherwise)
+		 */
+		std::mutex mutex;
+		/**
+		 * Recorded events
+		 */
+		std::vector<Record> records;
+	};
+
+	/**
+	 * Global state of the recorder
+	 */
+	struct State {
+		/**
+		 * Indicates whether the events are recorded
+		 */
+		std::atomic<bool> enabled;
+		/**
+		 * Reference time of the trace
+		 */
+		const std::chrono::steady_clock::time_point epoch;
+		/**
+		 * Lock of the list of buffers
+		 */
+		std::mutex mutex;
+		/**
+		 * Buffers of all the threads which have recorded events
+		 */
+		std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+
+		/**
+		 * Class constructor
+		 */
+		State() : enabled(false), epoch(std::chrono::steady_clock::now()) {
+		};
+	};
+
+	/**
+	 * Initial capacity of the thread buffers (in events)
+	 */
+	static const size_t BUFFER_CAPACITY = 4096;
+
+	/**
+	 * Obtain the global state of the recorder
+	 */
+	static State& state() {
+		static State instance;
+		return instance;
+	};
+
+	/**
+	 * Obtain the buffer of the calling thread (it is created the first time)
+	 */
+	static ThreadBuffer& threadBuffer() {
+		static thread_local std::shared_ptr<ThreadBuffer> buffer;
+		if (!buffer) {
+			buffer = std::make_shared<ThreadBuffer>();
+			buffer->records.reserve(BUFFER_CAPACITY);
+			State& s = state();
+			std::lock_guard<std::mutex> locker(s.mutex);
+			buffer->threadId = static_cast<unsigned int>(s.buffers.size()) + 1;
+			buffer->name = "thread " + std::to_string(buffer->threadId);
+			s.buffers.push_back(buffer);
+		}
+		return *buffer;
+	};
+
+	/**
+	 * Obtain the name of an event in the trace
+	 */
+	static const char* eventName(const TraceEvent event) {
+		switch (event) {
+		case TraceEvent::SUBMIT:				return "submit";
+		case TraceEvent::START:					return "execute";
+		case TraceEvent::END:					return "execute";
+		case TraceEvent::ENQUEUE_COMPLETION:	return "enqueue completion";
+		default:								return "notify";
+		}
+	};
+
+	/**
+	 * Write the timestamp of an event (in microseconds, as expected by the format)
+	 */
+	static void writeTimestamp(std::ostream& ostr, const long long timestamp) {
+		ostr << "\"ts\":" << timestamp / 1000 << '.';
+		const long long fraction = timestamp % 1000;
+		ostr << (fraction < 100 ? (fraction < 10 ? "00" : "0") : "") << fraction;
+	};
+
+	/**
+	 * Class constructor
+	 */
+	TraceRecorder() {
+	};
+public:
+	/**
+	 * Start recording events
+	 */
+	static void enable() {
+		state().enabled.store(true, std::memory_order_relaxed);
+	};
+
+	/**
+	 * Stop recording events (the recorded ones are kept)
+	 */
+	static void disable() {
+		state().enabled.store(false, std::memory_order_relaxed);
+	};
+
+	/**
+	 * Verify whether the events are being recorded
+	 */
+	static bool isEnabled() {
+		return state().enabled.load(std::memory_order_relaxed);
+	};
+
+	/**
+	 * Record an event in the buffer of the calling thread
+	 * @param[in] event			Type of event
+	 * @param[in] operationId	Identifier of the operation
+	 */
+	static void record(const TraceEvent event, const unsigned long long operationId) {
+		const long long timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - state().epoch).count();
+		ThreadBuffer& buffer = threadBuffer();
+		std::lock_guard<std::mutex> locker(buffer.mutex);
+		buffer.records.push_back(Record{event, operationId, timestamp});
+	};
+
+	/**
+	 * Set the name of the calling thread in the trace
+	 * @param[in] name	Name of the thread
+	 */
+	static void setThreadName(const std::string& name) {
+		ThreadBuffer& buffer = threadBuffer();
+		std::lock_guard<std::mutex> locker(buffer.mutex);
+		buffer.name = name + " " + std::to_string(buffer.threadId);
+	};
+
+	/**
+	 * Remove the recorded events
+	 */
+	static void clear() {
+		State& s = state();
+		std::lock_guard<std::mutex> locker(s.mutex);
+		for (std::shared_ptr<ThreadBuffer>& buffer : s.buffers) {
+			std::lock_guard<std::mutex> bufferLocker(buffer->mutex);
+			buffer->records.clear();
+		}
+	};
+
+	/**
+	 * Export the recorded events in the Chrome trace-event JSON format. The execution of each
+	 * operation is a slice in its worker thread; the submission, completion enqueueing and
+	 * notification are instant events; and the whole lifecycle of each operation (from its
+	 * submission to its notification) is an asynchronous slice.
+	 * @param[in] ostr	Output where the trace is written
+	 */
+	static void writeChromeTrace(std::ostream& ostr) {
+		State& s = state();
+		std::lock_guard<std::mutex> locker(s.mutex);
+		ostr << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		for (std::shared_ptr<ThreadBuffer>& buffer : s.buffers) {
+			std::lock_guard<std::mutex> bufferLocker(buffer->mutex);
+			ostr << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->threadId
+				 << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+			first = false;
+			for (const Record& record : buffer->records) {
+				ostr << ",\n{\"name\":\"" << eventName(record.event) << "\",\"cat\":\"operation\",\"pid\":1,\"tid\":"
+					 << buffer->threadId << ",";
+				writeTimestamp(ostr, record.timestamp);
+				switch (record.event) {
+				case TraceEvent::START:
+					ostr << ",\"ph\":\"B\"";
+					break;
+				case TraceEvent::END:
+					ostr << ",\"ph\":\"E\"";
+					break;
+				default:
+					ostr << ",\"ph\":\"i\",\"s\":\"t\"";
+					break;
+				}
+				ostr << ",\"args\":{\"operation\":" << record.operationId << "}}";
+
+				// Lifecycle of the operation
+				if ((record.event == TraceEvent::SUBMIT) || (record.event == TraceEvent::NOTIFY)) {
+					ostr << ",\n{\"name\":\"operation " << record.operationId << "\",\"cat\":\"lifecycle\",\"pid\":1,\"tid\":"
+						 << buffer->threadId << ",\"id\":" << record.operationId << ",";
+					writeTimestamp(ostr, record.timestamp);
+					ostr << ",\"ph\":\"" << (record.event == TraceEvent::SUBMIT ? 'b' : 'e') << "\"}";
+				}
+			}
+		}
+		ostr << "\n]}\n";
+	};
+};
+
+/**
+ * Record an event of an operation, if the tracing support is compiled in and enabled. Otherwise,
+ * the cost is a relaxed atomic load (or nothing at all if it is not compiled in)
+ * @param[in] event			Type of event
+ * @param[in] operationId	Identifier of the operation
+ */
+inline void traceEvent(const TraceEvent event, const unsigned long long operationId) {
+	if (TRACE_COMPILED && TraceRecorder::isEnabled())
+		TraceRecorder::record(event, operationId);
+}
+
+/**
+ * Set the name of the calling thread in the trace, if the tracing support is compiled in
+ * @param[in] name	Name of the thread
+ */
+inline void traceThreadName(const char* name) {
+	if (TRACE_COMPILED)
+		TraceRecorder::setThreadName(name);
+}
+
+} /* namespace trace */
+} /* namespace proactor */
+
+#endif /* TRACE_TRACERECORDER_HPP_ */
@@ -0,0 +1,124 @@
+/**
+ * @file RingBuffer.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief FIFO queue which keeps its storage, so it does not allocate once it has grown.
+ */
+
+#ifndef UTILS_RINGBUFFER_HPP_
+#define UTILS_RINGBUFFER_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace proactor {
+namespace utils {
+
+/**
+ * This class is a FIFO queue stored in a circular buffer. Unlike std::deque, which frees and allocates
+ * a block every few elements as they go through it, the buffer only grows (doubling its capacity) when
+ * it is full and is never shrunk, so a queue in a steady state does not allocate. It is not thread-safe.
+ * @tparam T	Type of the elements (default constructible)
+ */
+template <typename T>
+class RingBuffer {
+private:
+	/**
+	 * Storage (its size is a power of two)
+	 */
+	std::vector<T> buffer;
+	/**
+	 * Position of the first element
+	 */
+	size_t head;
+	/**
+	 * Number of elements
+	 */
+	size_t count;
+
+	/**
+	 * Double the capacity, moving the elements to the beginning of the new storage
+	 */
+	void grow() {
+		std::vector<T> larger(buffer.empty() ? 16 : buffer.size() * 2);
+		for (size_t i = 0; i < count; ++i)
+			larger[i] = std::move((*this)[i]);
+		buffer.swap(larger);
+		head = 0;
+	};
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] capacity	Initial capacity (rounded up to a power of two)
+	 */
+	explicit RingBuffer(const size_t capacity = 0) : head(0), count(0) {
+		size_t size = 16;
+		while (size < capacity)
+			size *= 2;
+		buffer.resize(size);
+	};
+
+	/**
+	 * Add an element at the end of the queue
+	 * @param[in] element	Element
+	 */
+	void push_back(const T& element) {
+		if (count == buffer.size())
+			grow();
+		buffer[(head + count) & (buffer.size() - 1)] = element;
+		++count;
+	};
+
+	/**
+	 * Obtain the first element (the queue must not be empty)
+	 */
+	T& front() {
+		return buffer[head];
+	};
+
+	/**
+	 * Remove the first element (the queue must not be empty)
+	 */
+	void pop_front() {
+		buffer[head] = T();
+		head = (head + 1) & (buffer.size() - 1);
+		--count;
+	};
+
+	/**
+	 * Obtain an element by its position in the queue (0 is the first one)
+	 * @param[in] index	Position of the element
+	 */
+	T& operator[](const size_t index) {
+		return buffer[(head + index) & (buffer.size() - 1)];
+	};
+
+	/**
+	 * Obtain the number of elements
+	 */
+	size_t size() const {
+		return count;
+	};
+
+	/**
+	 * Verify whether the queue is empty
+	 */
+	bool empty() const {
+		return count == 0;
+	};
+
+	/**
+	 * Remove all the elements (the capacity is kept)
+	 */
+	void clear() {
+		while (count > 0)
+			pop_front();
+	};
+};
+
+} /* namespace utils */
+} /* namespace proactor */
+
+#endif /* UTILS_RINGBUFFER_HPP_ */
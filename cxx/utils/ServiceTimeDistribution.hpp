@@ -0,0 +1,187 @@
+/**
+ * @file ServiceTimeDistribution.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Distributions of the service time of synthetic operations.
+ */
+
+#ifndef UTILS_SERVICETIMEDISTRIBUTION_HPP_
+#define UTILS_SERVICETIMEDISTRIBUTION_HPP_
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace proactor {
+namespace utils {
+
+/**
+ * This class defines the distribution of the time needed to serve an operation. The
+ * distribution does not keep any state, so it can be shared between threads (each one
+ * samples it with its own random number generator).
+ * All the times are given in microseconds.
+ */
+class ServiceTimeDistribution {
+public:
+	/**
+	 * Supported distributions
+	 */
+	enum class Type {
+		/**
+		 * Always the same time (mean)
+		 */
+		CONSTANT,
+		/**
+		 * Exponential distribution with the given mean
+		 */
+		EXPONENTIAL,
+		/**
+		 * Most of the operations take the mean time and some of them (slowProbability) the slow time
+		 */
+		BIMODAL,
+		/**
+		 * Pareto distribution with the given mean and shape (heavy-tailed: the lower the shape, the
+		 * heavier the tail)
+		 */
+		PARETO
+	};
+
+private:
+	/**
+	 * Type of distribution
+	 */
+	Type type;
+	/**
+	 * Mean time (or time of the fast operations in the bimodal distribution)
+	 */
+	double mean;
+	/**
+	 * Time of the slow operations in the bimodal distribution
+	 */
+	double slow;
+	/**
+	 * Probability of the slow operations in the bimodal distribution
+	 */
+	double slowProbability;
+	/**
+	 * Shape of the Pareto distribution (it must be greater than 1 for the mean to exist)
+	 */
+	double shape;
+
+	/**
+	 * Split a specification in its fields
+	 */
+	static std::vector<std::string> split(const std::string& specification) {
+		std::vector<std::string> fields;
+		std::stringstream stream(specification);
+		std::string field;
+		while (std::getline(stream, field, ':'))
+			fields.push_back(field);
+		return fields;
+	};
+
+public:
+	/**
+	 * Class constructor
+	 * @param[in] type				Type of distribution
+	 * @param[in] mean				Mean time (or time of the fast operations in the bimodal distribution)
+	 * @param[in] slow				Time of the slow operations in the bimodal distribution
+	 * @param[in] slowProbability	Probability of the slow operations in the bimodal distribution
+	 * @param[in] shape				Shape of the Pareto distribution
+	 */
+	ServiceTimeDistribution(const Type type, const double mean, const double slow = 0, const double slowProbability = 0,
+							const double shape = 2) :
+								type(type), mean(mean), slow(slow), slowProbability(slowProbability), shape(shape) {
+		if ((mean < 0) || (slow < 0) || (slowProbability < 0) || (slowProbability > 1) || (shape <= 1))
+			throw std::invalid_argument("Invalid service time distribution");
+	};
+
+	/**
+	 * Create a distribution from its specification:
+	 * - const:MEAN
+	 * - exp:MEAN
+	 * - bimodal:FAST:SLOW:SLOW_PROBABILITY
+	 * - pareto:MEAN:SHAPE
+	 * @param[in] specification	Specification of the distribution (times in microseconds)
+	 * @return					Distribution
+	 * @throw std::invalid_argument if the specification is not valid
+	 */
+	static ServiceTimeDistribution parse(const std::string& specification) {
+		const std::vector<std::string> fields = split(specification);
+		try {
+			if ((fields.size() == 2) && (fields[0] == "const"))
+				return ServiceTimeDistribution(Type::CONSTANT, std::stod(fields[1]));
+			if ((fields.size() == 2) && (fields[0] == "exp"))
+				return ServiceTimeDistribution(Type::EXPONENTIAL, std::stod(fields[1]));
+			if ((fields.size() == 4) && (fields[0] == "bimodal"))
+				return ServiceTimeDistribution(Type::BIMODAL, std::stod(fields[1]), std::stod(fields[2]), std::stod(fields[3]));
+			if ((fields.size() == 3) && (fields[0] == "pareto"))
+				return ServiceTimeDistribution(Type::PARETO, std::stod(fields[1]), 0, 0, std::stod(fields[2]));
+		} catch (std::logic_error&) {
+			// Not a number: reported below
+		}
+		throw std::invalid_argument("Invalid service time distribution: " + specification);
+	};
+
+	/**
+	 * Obtain the specification of the distribution (the inverse of parse)
+	 * @return	Specification of the distribution
+	 */
+	std::string toString() const {
+		std::ostringstream stream;
+		stream.precision(17);
+		switch (type) {
+		case Type::CONSTANT:
+			stream << "const:" << mean;
+			break;
+		case Type::EXPONENTIAL:
+			stream << "exp:" << mean;
+			break;
+		case Type::BIMODAL:
+			stream << "bimodal:" << mean << ':' << slow << ':' << slowProbability;
+			break;
+		case Type::PARETO:
+			stream << "pareto:" << mean << ':' << shape;
+			break;
+		}
+		return stream.str();
+	};
+
+	/**
+	 * Draw a service time
+	 * @param[in] generator	Random number generator (of the calling thread)
+	 * @return				Service time
+	 */
+	template <typename Generator>
+	std::chrono::nanoseconds sample(Generator& generator) const {
+		double time = mean;
+		switch (type) {
+		case Type::CONSTANT:
+			break;
+		case Type::EXPONENTIAL:
+			time = (mean > 0) ? std::exponential_distribution<double>(1.0 / mean)(generator) : 0;
+			break;
+		case Type::BIMODAL:
+			if (std::bernoulli_distribution(slowProbability)(generator))
+				time = slow;
+			break;
+		case Type::PARETO: {
+			// Inverse transform sampling with the scale that gives the requested mean
+			const double scale = mean * (shape - 1) / shape;
+			const double uniform = std::uniform_real_distribution<double>(0, 1)(generator);
+			time = scale / std::pow(1 - uniform, 1 / shape);
+			break;
+		}
+		}
+		return std::chrono::nanoseconds(static_cast<long long>(time * 1000));
+	};
+};
+
+} /* namespace utils */
+} /* namespace proactor */
+
+#endif /* UTILS_SERVICETIMEDISTRIBUTION_HPP_ */
@@ -6,9 +6,14 @@
 
 #include <chrono>
 #include <ctime>
+#include <functional>
 #include <iomanip>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
 
 #ifndef SRC_UTILS_H_
 #define SRC_UTILS_H_
@@ -22,18 +27,62 @@ namespace utils {
 class Utils {
 public:
 
+	/**
+	 * Indicates whether a type is formatted as a number by tostr without a string stream (the
+	 * characters and booleans are not, as they are not displayed as numbers)
+	 */
+	template<typename T>
+	struct IsNumber {
+		static const bool value = std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+				!std::is_same<T, char>::value && !std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value;
+	};
+
 	/**
 	 * Converts a generic type value to a string
 	 * @param[in] t	Value to be converted into a string
 	 * @return		Converted value (in string format)
 	 */
 	template<typename T>
-	static std::string tostr(T t) {
+	static typename std::enable_if<!IsNumber<T>::value, std::string>::type tostr(T t) {
 		std::stringstream os;
 		os << t;
 		return os.str();
 	};
 
+	/**
+	 * Converts an integer to a string. The digits are written in a local buffer (as std::to_chars
+	 * does), so no string stream is created and short numbers do not allocate
+	 * @param[in] t	Value to be converted into a string
+	 * @return		Converted value (in string format)
+	 */
+	template<typename T>
+	static typename std::enable_if<IsNumber<T>::value, std::string>::type tostr(T t) {
+		typedef typename std::make_unsigned<T>::type Unsigned;
+		// The magnitude is computed in the unsigned type, so that the minimum value does not overflow
+		Unsigned magnitude = (t < 0) ? Unsigned(0) - Unsigned(t) : Unsigned(t);
+		char buffer[std::numeric_limits<Unsigned>::digits10 + 2];
+		char* const end = buffer + sizeof(buffer);
+		char* begin = end;
+		do {
+			*--begin = static_cast<char>('0' + magnitude % 10);
+			magnitude /= 10;
+		} while (magnitude != 0);
+		if (t < 0)
+			*--begin = '-';
+		return std::string(begin, end);
+	};
+
+	/**
+	 * Obtain the random number generator of the calling thread. Each thread has its own generator
+	 * (unlike std::rand, which is not thread-safe), seeded from std::random_device and the thread id
+	 * @return	Random number generator of the calling thread
+	 */
+	static std::mt19937_64& randomGenerator() {
+		static thread_local std::mt19937_64 generator(std::random_device{}() ^
+				std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		return generator;
+	};
+
 	/**
 	 * Convert a date/time into a string
 	 * @param[in] time	Date/time to convert
@@ -0,0 +1,122 @@
+/**
+ * @file ActivitySlot.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief What a thread of the engine is doing, published for the watchdog.
+ */
+
+#ifndef WATCHDOG_ACTIVITYSLOT_HPP_
+#define WATCHDOG_ACTIVITYSLOT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace proactor {
+namespace watchdog {
+
+/**
+ * Activities watched by the watchdog
+ */
+enum class StallKind {
+	/**
+	 * Execution of an operation (in a worker)
+	 */
+	OPERATION,
+	/**
+	 * Dispatch of a completion (in the proactor thread)
+	 */
+	DISPATCH
+};
+
+/**
+ * This class publishes the activity of a thread: the operation it is executing (or whose completion
+ * it is dispatching) and since when. The owner thread writes it with a few atomic stores per
+ * operation and the watchdog thread samples it, so no lock is taken in the hot path.
+ * @see Watchdog
+ */
+class ActivitySlot {
+private:
+	/**
+	 * Operation in progress (0 if the thread is idle)
+	 */
+	std::atomic<uint64_t> operationId;
+	/**
+	 * Time when the operation started (steady clock, in nanoseconds)
+	 */
+	std::atomic<int64_t> since;
+
+public:
+	/**
+	 * Activity of the thread
+	 */
+	const StallKind kind;
+	/**
+	 * Name of the thread
+	 */
+	const std::string name;
+	/**
+	 * Identifier of the thread in the operating system (as shown by top or perf)
+	 */
+	const int64_t threadId;
+	/**
+	 * Operation and start time of the last stall reported for this slot (only used by the watchdog)
+	 */
+	uint64_t reportedOperation;
+	int64_t reportedSince;
+
+	/**
+	 * Class constructor
+	 * @param[in] kind		Activity of the thread
+	 * @param[in] name		Name of the thread
+	 * @param[in] threadId	Identifier of the thread in the operating system
+	 */
+	ActivitySlot(const StallKind kind, const std::string& name, const int64_t threadId) :
+		operationId(0), since(0), kind(kind), name(name), threadId(threadId), reportedOperation(0), reportedSince(0) {
+	};
+
+	/**
+	 * Obtain the current time, as stored in the slot
+	 */
+	static int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	/**
+	 * Publish that the thread starts working on an operation (only from the owner thread)
+	 * @param[in] operation	Identifier of the operation
+	 */
+	void begin(const uint64_t operation) {
+		since.store(now(), std::memory_order_relaxed);
+		operationId.store(operation, std::memory_order_release);
+	};
+
+	/**
+	 * Publish that the thread has finished its operation (only from the owner thread)
+	 */
+	void end() {
+		operationId.store(0, std::memory_order_release);
+	};
+
+	/**
+	 * Sample the activity of the thread
+	 * @param[out] operation	Operation in progress
+	 * @param[out] start		Time when it started
+	 * @return					False if the thread is idle (or has changed its operation while sampling)
+	 */
+	bool sample(uint64_t& operation, int64_t& start) const {
+		operation = operationId.load(std::memory_order_acquire);
+		if (operation == 0)
+			return false;
+		start = since.load(std::memory_order_relaxed);
+		// The start time belongs to the operation only if it has not changed meanwhile
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return operationId.load(std::memory_order_relaxed) == operation;
+	};
+};
+
+} /* namespace watchdog */
+} /* namespace proactor */
+
+#endif /* WATCHDOG_ACTIVITYSLOT_HPP_ */
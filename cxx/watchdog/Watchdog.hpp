@@ -0,0 +1,275 @@
+/**
+ * @file Watchdog.hpp
+ * @author Ronald T. Fernandez
+ * @version 1.0
+ * @brief Thread which detects the operations and the dispatches of completions which take too long.
+ */
+
+#ifndef WATCHDOG_WATCHDOG_HPP_
+#define WATCHDOG_WATCHDOG_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../logger/Logger.hpp"
+#include "../utils/Utils.hpp"
+#include "ActivitySlot.hpp"
+
+namespace proactor {
+namespace watchdog {
+
+/**
+ * Description of a stall
+ */
+struct StallReport {
+	/**
+	 * Stalled activity
+	 */
+	StallKind kind;
+	/**
+	 * Operation being executed or dispatched
+	 */
+	uint64_t operationId;
+	/**
+	 * Identifier of the stalled thread in the operating system
+	 */
+	int64_t threadId;
+	/**
+	 * Name of the stalled thread
+	 */
+	std::string threadName;
+	/**
+	 * Time the operation has been running when the stall was detected
+	 */
+	std::chrono::nanoseconds elapsed;
+};
+
+/**
+ * This class samples periodically what the threads of the engine are doing (see ActivitySlot) and
+ * reports the operations which have been executing for longer than a threshold, and the completions
+ * whose dispatch (the client handler invoked by the proactor thread) has taken longer than a limit.
+ * Each stall is reported once, through a callback invoked in the watchdog thread, and counted.
+ * The watched threads only pay a few atomic stores per operation.
+ * @see initiatorCompletion::InitiatorCompletion
+ */
+class Watchdog {
+public:
+	/**
+	 * Function invoked when a stall is detected
+	 */
+	typedef std::function<void(const StallReport&)> Callback;
+
+	/**
+	 * Counters of the watchdog
+	 */
+	struct Statistics {
+		/**
+		 * Operations which have exceeded the threshold
+		 */
+		uint64_t operationStalls;
+		/**
+		 * Dispatches which have exceeded the limit
+		 */
+		uint64_t dispatchStalls;
+		/**
+		 * Longest stall observed (with the precision of the sampling interval)
+		 */
+		std::chrono::nanoseconds longestStall;
+	};
+
+private:
+	/**
+	 * Threshold of the operations
+	 */
+	const std::chrono::nanoseconds operationThreshold;
+	/**
+	 * Limit of the dispatches
+	 */
+	const std::chrono::nanoseconds dispatchThreshold;
+	/**
+	 * Time between two samples
+	 */
+	const std::chrono::nanoseconds interval;
+	/**
+	 * Function invoked when a stall is detected
+	 */
+	const Callback callback;
+	/**
+	 * Lock of the slots, the counters and the stop flag
+	 */
+	std::mutex mutex;
+	/**
+	 * Condition variable used to stop the watchdog
+	 */
+	std::condition_variable cv;
+	/**
+	 * Slots of the watched threads (a list, so that their addresses do not change)
+	 */
+	std::list<ActivitySlot> slots;
+	/**
+	 * Counters
+	 */
+	Statistics statistics;
+	/**
+	 * Indicates that the watchdog has to finish
+	 */
+	bool stop;
+	/**
+	 * Watchdog thread
+	 */
+	std::thread thread;
+
+	/**
+	 * Obtain the time between two samples
+	 * @param[in] operationThreshold	Limit of the operations
+	 * @param[in] dispatchThreshold		Limit of the dispatches
+	 * @param[in] interval				Requested interval (zero for a quarter of the lowest threshold)
+	 * @return							Interval, at least 100 microseconds so that the watchdog does not spin
+	 */
+	static std::chrono::nanoseconds samplingInterval(const std::chrono::nanoseconds& operationThreshold,
+													 const std::chrono::nanoseconds& dispatchThreshold,
+													 const std::chrono::nanoseconds& interval) {
+		const std::chrono::nanoseconds requested = (interval > std::chrono::nanoseconds::zero()) ?
+				interval : std::min(operationThreshold, dispatchThreshold) / 4;
+		return std::max<std::chrono::nanoseconds>(requested, std::chrono::microseconds(100));
+	};
+
+	/**
+	 * Obtain the identifier of the calling thread in the operating system
+	 */
+	static int64_t currentThreadId() {
+		static thread_local const int64_t threadId = syscall(SYS_gettid);
+		return threadId;
+	};
+
+	/**
+	 * Report the stalls by default: they are logged
+	 */
+	static void log(const StallReport& report) {
+		logger::Logger::log(std::string(report.kind == StallKind::OPERATION ? "Stalled operation " : "Stalled dispatch of operation ") +
+				utils::Utils::tostr(report.operationId) + " in thread " + report.threadName + " (" +
+				utils::Utils::tostr(report.threadId) + ") for " +
+				utils::Utils::tostr(std::chrono::duration_cast<std::chrono::milliseconds>(report.elapsed).count()) + " ms");
+	};
+
+	/**
+	 * Main loop of the watchdog thread
+	 */
+	void watch() {
+		std::vector<StallReport> reports;
+		std::unique_lock<std::mutex> locker(mutex);
+		while (!cv.wait_for(locker, interval, [&]{ return stop;})) {
+			const int64_t now = ActivitySlot::now();
+			for (ActivitySlot& slot : slots) {
+				uint64_t operation;
+				int64_t start;
+				if (!slot.sample(operation, start))
+					continue;
+				const std::chrono::nanoseconds elapsed(now - start);
+				if (elapsed <= ((slot.kind == StallKind::OPERATION) ? operationThreshold : dispatchThreshold))
+					continue;
+				// A stall is reported once, but followed until it ends
+				statistics.longestStall = std::max(statistics.longestStall, elapsed);
+				if ((slot.reportedOperation == operation) && (slot.reportedSince == start))
+					continue;
+				slot.reportedOperation = operation;
+				slot.reportedSince = start;
+				if (slot.kind == StallKind::OPERATION)
+					++statistics.operationStalls;
+				else
+					++statistics.dispatchStalls;
+				reports.push_back(StallReport{slot.kind, operation, slot.threadId, slot.name, elapsed});
+			}
+			// The callback is invoked without the lock, so it can query the statistics
+			locker.unlock();
+			for (const StallReport& report : reports)
+				callback(report);
+			reports.clear();
+			locker.lock();
+		}
+	};
+
+public:
+	/**
+	 * Class constructor. It starts the watchdog thread
+	 * @param[in] operationThreshold	An operation which runs for longer is reported
+	 * @param[in] dispatchThreshold		A completion whose dispatch takes longer is reported
+	 * @param[in] callback				Function invoked (in the watchdog thread) when a stall is detected. The
+	 * 									stalls are logged if it is not defined
+	 * @param[in] interval				Time between two samples (a quarter of the lowest threshold if it is zero).
+	 * 									It is never shorter than 100 microseconds
+	 * @throw std::invalid_argument if a threshold is not positive
+	 */
+	Watchdog(const std::chrono::nanoseconds& operationThreshold,
+			 const std::chrono::nanoseconds& dispatchThreshold,
+			 const Callback& callback = Callback(),
+			 const std::chrono::nanoseconds& interval = std::chrono::nanoseconds::zero()) :
+				 operationThreshold(operationThreshold),
+				 dispatchThreshold(dispatchThreshold),
+				 interval(samplingInterval(operationThreshold, dispatchThreshold, interval)),
+				 callback(callback ? callback : Callback(&Watchdog::log)),
+				 statistics(),
+				 stop(false) {
+		if ((operationThreshold <= std::chrono::nanoseconds::zero()) || (dispatchThreshold <= std::chrono::nanoseconds::zero()))
+			throw std::invalid_argument("The thresholds of the watchdog must be positive");
+		thread = std::thread(&Watchdog::watch, this);
+	};
+
+	/**
+	 * Class destructor. It stops the watchdog thread
+	 */
+	virtual ~Watchdog() {
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			stop = true;
+		}
+		cv.notify_one();
+		thread.join();
+	};
+
+	/**
+	 * Watch the calling thread
+	 * @param[in] kind	Activity of the thread
+	 * @param[in] name	Name of the thread in the reports
+	 * @return			Slot where the thread publishes its activity. It is valid until it is unregistered
+	 */
+	ActivitySlot* registerThread(const StallKind kind, const std::string& name) {
+		std::lock_guard<std::mutex> locker(mutex);
+		slots.emplace_back(kind, name, currentThreadId());
+		return &slots.back();
+	};
+
+	/**
+	 * Stop watching a thread
+	 * @param[in] slot	Slot of the thread
+	 */
+	void unregisterThread(const ActivitySlot* slot) {
+		std::lock_guard<std::mutex> locker(mutex);
+		slots.remove_if([slot](const ActivitySlot& candidate) { return &candidate == slot;});
+	};
+
+	/**
+	 * Obtain the counters of the watchdog
+	 */
+	Statistics getStatistics() {
+		std::lock_guard<std::mutex> locker(mutex);
+		return statistics;
+	};
+};
+
+} /* namespace watchdog */
+} /* namespace proactor */
+
+#endif /* WATCHDOG_WATCHDOG_HPP_ */